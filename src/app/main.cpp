@@ -3,11 +3,25 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <rtl/guid.h>
+#include <rtl/FilesystemLib.h>
 #include <utils/string_utils.h>
 #include "../utils/UnitTestExecUtils.h"
 #include "../utils/constants.h"
+#include "../utils/ChildProcess.h"
+#include "../utils/TestResults.h"
+#include "../utils/TimeoutPolicy.h"
+#include "../utils/TestSelection.h"
+#include "../utils/ResultCache.h"
+#include "../utils/AllocationCounter.h"
+#include "../utils/EventGenerator.h"
+#include "../utils/EventAuditor.h"
 #include "../testers/RegressionTester.h"
+#include "../testers/ChainBenchmark.h"
+#include "../testers/SoakTester.h"
+#include "../testers/ScanBenchmark.h"
 
 
 void logApplicationStart() {
@@ -37,7 +51,291 @@ void print_help() {
         "<config_path> - path to filter chain config file\n"
         "a) -u <filter_guid>\n"
         "b) -r <config_path>\n"
-        "If no <filter_guid> is passed, all tests across all filters will be executed.\n";
+        "c) -p <filter_guid> - measures throughput of filter's Execute for every event code\n"
+        "d) -b <config_path> - measures throughput of the whole filter chain, with log filters replaced "
+        "by an in-memory sink\n"
+        "e) -s <filter_guid>|<config_path> - soak test, executes a steady rate of generated events for a long time "
+        "and reports growth of memory and open files and latency drift\n"
+        "f) -l <log_path> - measures finding of separators and line breaks in a log with every available scanner\n"
+        "<config_path> may also be a directory, every " << cnst::CONFIG_FILE << " found in it is then tested.\n"
+        "Numeric columns of the regression logs are compared with absolute tolerance 0.0001, unless the scenario directory "
+        "contains " << cnst::TOLERANCE_FILE << " with lines \"<column>; absolute|relative|ulp; <tolerance>[; <signal>]\"\n"
+        "If no <filter_guid> is passed, all tests (or benchmarks) across all filters will be executed.\n"
+        "Options:\n"
+        "-j <count> ... number of filters tested in parallel when executing all unit tests "
+        "(0 = one per hardware thread)\n"
+        "--isolate ... executes every unit test in a child process, which is killed when the test times out "
+        "(testers are then executed one at a time, -j is ignored)\n"
+        "--fork-server ... like --isolate, but scgms and all filter libraries are loaded once and inherited "
+        "by the forked children\n"
+        "--timeout <ms> ... default timeout of unit tests which don't request their own\n"
+        "--adaptive-timeout <factor> ... derives the timeout of unit tests with recorded history from the 99th percentile "
+        "of their durations multiplied by <factor>\n"
+        "--filter <regex> ... executes only tests whose \"<filter name>/<test name>\" (unit tests) or "
+        "\"regression/<scenario directory>\" (regression tests) matches the regular expression\n"
+        "--shard <i>/<n> ... executes only the i-th of n deterministic parts of the selected tests (1 <= i <= n)\n"
+        "--events <count> ... number of events per event code executed by the -p benchmark, by --stress "
+        "and generated by --generate (default 100000)\n"
+        "--stress ... instead of the -p benchmark, executes level events from 1 to <threads> threads at once "
+        "and reports throughput scaling and lost or duplicated events\n"
+        "--threads <count> ... maximum number of threads used by --stress (default one per hardware thread)\n"
+        "--generate ... -p additionally measures a synthetic stream of --events events, --stress executes the stream "
+        "instead of level events and -b executes it upon the chain, followed by a shut down event\n"
+        "--mix <code>:<weight>,... ... event codes of the stream - level, masked, parameters, information "
+        "(default level:85,masked:5,parameters:5,information:5), implies --generate\n"
+        "--signals <signal>:<weight>,... ... signals of the stream - BG, IG, ISIG, COB, IOB, Calibration, Carb_Intake "
+        "or a GUID (default IG:70,BG:20,COB:10), implies --generate\n"
+        "--segment <count> ... number of events in one time segment of the stream, 0 = no segments (default), "
+        "implies --generate\n"
+        "--seed <number> ... seed of the stream, implies --generate\n"
+        "--duration <seconds> ... duration of the -s soak test (default 60)\n"
+        "--rate <events> ... number of events per second executed by the -s soak test (default 1000)\n"
+        "--interval <seconds> ... time between two samples of the -s soak test (default 10)\n"
+        "--runs <count> ... number of executions of the chain benchmarked by -b and of scans by -l (default 5)\n"
+        "--alloc ... the -p benchmark also counts heap allocations made by the filter per event, including aligned ones "
+        "(glibc builds configured with -DSMARTTESTER_ALLOCATION_COUNTING=ON only)\n"
+        "--audit-events ... counts every event created by the unit tests and benchmarks against its final release "
+        "and reports events still alive when a test ends, per test and per filter (tests in child processes "
+        "report into the log only, audited benchmarks are slower)\n"
+        "--cache ... skips tests which already passed, unless the tester, scgms, tested filter library "
+        "or scenario files changed since\n";
+}
+
+/**
+ * Options passed on the command-line after the test type.
+ */
+struct TExecution_Options {
+    /// Tested subject - filter GUID, path to the configuration file or to the scanned log
+    std::string subject;
+    /// Number of filters tested in parallel
+    unsigned int jobs = 1;
+    /// Whether unit tests are executed in child processes
+    bool isolate = false;
+    /// Whether libraries are loaded before forking the child processes
+    bool preload = false;
+    /// Default timeout of unit tests in milliseconds, 0 if not set
+    long timeout = 0;
+    /// Multiplier of recorded test durations, 0 if adaptive timeouts are disabled
+    double adaptiveFactor = 0.0;
+    /// Number of events per event code executed by the benchmark
+    std::size_t eventCount = 100000;
+    /// Whether the benchmark counts heap allocations
+    bool countAllocations = false;
+    /// Whether the benchmark executes events from multiple threads at once
+    bool stress = false;
+    /// Maximum number of threads of the stress benchmark, 0 means one per hardware thread
+    unsigned int threads = 0;
+    /// Number of executions of the benchmarked filter chain
+    std::size_t runs = 5;
+    /// Whether the benchmarks execute a synthetic stream of events
+    bool generate = false;
+    /// Configuration of the synthetic stream
+    TGenerator_Config generator;
+    /// Parameters of the soak test
+    tester::TSoak_Options soak;
+    /// Whether lifetime of events created by the tests is audited
+    bool auditEvents = false;
+};
+
+/**
+ * Parses shard specification "<i>/<n>" and selects the shard in TestSelection. If the specification is invalid,
+ * system will shut down.
+ *
+ * @param shard shard specification from command-line
+ */
+void select_shard(const std::string& shard) {
+    try {
+        size_t separator = shard.find('/');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument("Missing shard count");
+        }
+
+        unsigned long index = std::stoul(shard.substr(0, separator));
+        unsigned long count = std::stoul(shard.substr(separator + 1));
+        if (index == 0) {
+            throw std::invalid_argument("Shards are numbered from one");
+        }
+
+        tester::TestSelection::getInstance().setShard(index - 1, count);
+    } catch (std::exception&) {
+        std::wcerr << L"Invalid shard passed! Expected format: <i>/<n>\n";
+        Logger::getInstance().error(L"Invalid shard passed!");
+        exit(2);
+    }
+}
+
+/**
+ * Parses command-line parameters following the test type. Known options are consumed together with their values,
+ * the first remaining parameter is taken as the tested subject. If an option has invalid value, system will shut down.
+ *
+ * @param argc number of command-line parameters
+ * @param argv command-line parameters
+ * @return parsed options
+ */
+TExecution_Options parse_options(int argc, char* argv[]) {
+    TExecution_Options options;
+
+    for (int i = 2; i < argc; i++) {
+        std::string argument = argv[i];
+
+        if (argument == "-j") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing job count");
+                }
+                options.jobs = std::stoul(argv[++i]);
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid job count passed!\n";
+                Logger::getInstance().error(L"Invalid job count passed!");
+                exit(2);
+            }
+        } else if (argument == "--timeout") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing timeout");
+                }
+                options.timeout = std::stol(argv[++i]);
+                if (options.timeout <= 0) {
+                    throw std::out_of_range("Non-positive timeout");
+                }
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid timeout passed!\n";
+                Logger::getInstance().error(L"Invalid timeout passed!");
+                exit(2);
+            }
+        } else if (argument == "--adaptive-timeout") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing factor");
+                }
+                options.adaptiveFactor = std::stod(argv[++i]);
+                if (options.adaptiveFactor <= 0.0) {
+                    throw std::out_of_range("Non-positive factor");
+                }
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid adaptive timeout factor passed!\n";
+                Logger::getInstance().error(L"Invalid adaptive timeout factor passed!");
+                exit(2);
+            }
+        } else if (argument == "--filter") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing test filter");
+                }
+                std::string pattern = argv[++i];
+                tester::TestSelection::getInstance().setPattern(std::wstring{ pattern.begin(), pattern.end() });
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid test filter passed!\n";
+                Logger::getInstance().error(L"Invalid test filter passed!");
+                exit(2);
+            }
+        } else if (argument == "--shard") {
+            if (i + 1 >= argc) {
+                std::wcerr << L"Missing shard!\n";
+                Logger::getInstance().error(L"Missing shard!");
+                exit(2);
+            }
+            select_shard(argv[++i]);
+        } else if (argument == "--events") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing event count");
+                }
+                options.eventCount = std::stoull(argv[++i]);
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid event count passed!\n";
+                Logger::getInstance().error(L"Invalid event count passed!");
+                exit(2);
+            }
+        } else if (argument == "--stress") {
+            options.stress = true;
+        } else if (argument == "--threads") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing thread count");
+                }
+                options.threads = std::stoul(argv[++i]);
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid thread count passed!\n";
+                Logger::getInstance().error(L"Invalid thread count passed!");
+                exit(2);
+            }
+        } else if (argument == "--generate") {
+            options.generate = true;
+        } else if (argument == "--mix" || argument == "--signals" || argument == "--segment" || argument == "--seed") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing generator option value");
+                }
+
+                const std::string value = argv[++i];
+                if (argument == "--mix") {
+                    options.generator.eventCodes = EventGenerator::parseEventCodes(value);
+                } else if (argument == "--signals") {
+                    options.generator.signals = EventGenerator::parseSignals(value);
+                } else if (argument == "--segment") {
+                    options.generator.segmentLength = std::stoull(value);
+                } else {
+                    options.generator.seed = std::stoull(value);
+                }
+                options.generate = true;
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid value of " << argument.c_str() << L" passed!\n";
+                Logger::getInstance().error(L"Invalid value of " + Widen_String(argument) + L" passed!");
+                exit(2);
+            }
+        } else if (argument == "--duration" || argument == "--rate" || argument == "--interval") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing soak test option value");
+                }
+
+                const double value = std::stod(argv[++i]);
+                if (!(value > 0.0)) {
+                    throw std::invalid_argument("Soak test option has to be positive");
+                }
+
+                if (argument == "--duration") {
+                    options.soak.duration = value;
+                } else if (argument == "--rate") {
+                    options.soak.rate = value;
+                } else {
+                    options.soak.interval = value;
+                }
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid value of " << argument.c_str() << L" passed!\n";
+                Logger::getInstance().error(L"Invalid value of " + Widen_String(argument) + L" passed!");
+                exit(2);
+            }
+        } else if (argument == "--runs") {
+            try {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument("Missing run count");
+                }
+                options.runs = std::stoull(argv[++i]);
+            } catch (std::exception&) {
+                std::wcerr << L"Invalid run count passed!\n";
+                Logger::getInstance().error(L"Invalid run count passed!");
+                exit(2);
+            }
+        } else if (argument == "--alloc") {
+            options.countAllocations = true;
+        } else if (argument == "--audit-events") {
+            options.auditEvents = true;
+            tester::EventAuditor::getInstance().enable();
+        } else if (argument == "--cache") {
+            tester::ResultCache::getInstance().enable(argv[0]);
+        } else if (argument == "--isolate") {
+            options.isolate = true;
+        } else if (argument == "--fork-server") {
+            options.isolate = true;
+            options.preload = true;
+        } else if (options.subject.empty()) {
+            options.subject = argument;
+        }
+    }
+
+    return options;
 }
 
 /**
@@ -108,21 +406,117 @@ GUID parse_guid(std::string guid_string) {
     return guid;
 }
 
+/**
+ * Executes soak test upon a filter with given GUID or upon a filter chain loaded from given configuration file.
+ *
+ * @param options command-line options, the subject being guid in string format or path to the configuration
+ * @return S_OK if no growth of resources or latency drift was detected
+ */
+HRESULT execute_soak_test(const TExecution_Options& options) {
+    tester::SoakTester soakTester(options.soak, options.generator);
+
+    std::wstring subject{ options.subject.begin(), options.subject.end() };
+    if (!subject.empty() && filesystem::is_regular_file(subject)) {
+        return tester::ChainBenchmark(subject).executeSoakTest(soakTester);
+    }
+
+    GUID guid = parse_guid(options.subject);
+    if (Is_Invalid_GUID(guid)) {
+        std::wcerr << L"Soak test needs a filter GUID or a configuration file!\n";
+        Logger::getInstance().error(L"Soak test needs a filter GUID or a configuration file!");
+        return E_FAIL;
+    }
+    return tester::executeFilterSoakTest(guid, soakTester);
+}
+
 /**
  * Executes unit testing on all filters or on specific filter with given GUID.
  *
- * @param guid_string guid passed as command-line argument in string format
+ * @param options command-line options, the subject being guid in string format
  */
-void execute_unit_testing(std::string& guid_string) {
+void execute_unit_testing(const TExecution_Options& options) {
+
+    GUID guid = parse_guid(options.subject);
+
+    tester::TimeoutPolicy& timeoutPolicy = tester::TimeoutPolicy::getInstance();
+    if (options.timeout > 0) {
+        timeoutPolicy.setDefaultTimeout(options.timeout);
+    }
+    timeoutPolicy.setAdaptiveFactor(options.adaptiveFactor);
+
+    unsigned int jobs = options.jobs;
+    if (options.isolate) {
+        if (tester::isChildProcessSupported()) {
+            Logger::getInstance().info(L"Unit tests will be executed in child processes.");
+            tester::GenericUnitTester::setExecutionMode(tester::GenericUnitTester::NExecution_Mode::Child_Process);
+
+            /// Forking while other tester threads run would let the child inherit locks they hold, e.g. inside
+            /// the filter libraries, and deadlock on them, so the children are forked from the main thread only
+            if (jobs != 1) {
+                std::wcerr << L"Testers can't be executed in parallel with isolated tests, ignoring -j.\n";
+                Logger::getInstance().warn(L"Testers can't be executed in parallel with isolated tests, ignoring -j.");
+                jobs = 1;
+            }
+
+            if (options.preload && !tester::preloadLibraries()) {
+                std::wcerr << L"Some libraries couldn't be preloaded, affected tests will load them on their own.\n";
+            }
+        } else {
+            std::wcerr << L"Executing tests in child processes is not supported on this platform!\n";
+            Logger::getInstance().warn(L"Executing tests in child processes is not supported on this platform!");
+        }
+    }
 
-    GUID guid = parse_guid(guid_string);
-    
     if (Is_Invalid_GUID(guid)) {
-        tester::executeAllTests();
+        tester::executeAllTests(jobs);
     } else {
         tester::executeFilterTests(guid);
     }
 
+    tester::ResultCollector::getInstance().writeReports();
+    timeoutPolicy.recordResults(tester::ResultCollector::getInstance().getResults());
+    tester::ResultCache::getInstance().save();
+
+    if (options.auditEvents) {
+        tester::EventAuditor::getInstance().printSummary(std::wcout);
+    }
+}
+
+/**
+ * Measures event throughput of all filters or of specific filter with given GUID.
+ *
+ * @param options command-line options, the subject being guid in string format
+ * @return S_OK if all benchmarked filters accepted all events
+ */
+HRESULT execute_benchmark(const TExecution_Options& options) {
+    GUID guid = parse_guid(options.subject);
+
+    if (options.countAllocations) {
+        if (tester::isAllocationCountingSupported()) {
+            tester::GenericUnitTester::setAllocationCounting(true);
+        } else {
+            std::wcerr << L"Counting heap allocations is not supported by this build!\n";
+            Logger::getInstance().warn(L"Counting heap allocations is not supported by this build!");
+        }
+    }
+
+    if (options.generate) {
+        tester::GenericUnitTester::setEventGenerator(options.generator);
+    }
+
+    HRESULT result;
+    if (options.stress) {
+        result = Is_Invalid_GUID(guid) ? tester::executeAllStressTests(options.eventCount, options.threads)
+                                       : tester::executeFilterStressTest(guid, options.eventCount, options.threads);
+    } else {
+        result = Is_Invalid_GUID(guid) ? tester::executeAllBenchmarks(options.eventCount)
+                                       : tester::executeFilterBenchmark(guid, options.eventCount);
+    }
+
+    if (options.auditEvents) {
+        tester::EventAuditor::getInstance().printSummary(std::wcout);
+    }
+    return result;
 }
 
 /**
@@ -137,6 +531,20 @@ HRESULT execute_regression_testing(const std::wstring& config_filepath) {
         return 1;
     }
 
+    tester::ResultCache& cache = tester::ResultCache::getInstance();
+    std::wstring scenario;
+    std::uint64_t inputHash = 0;
+    if (cache.isEnabled()) {
+        filesystem::path scenarioDirectory = filesystem::absolute(config_filepath).parent_path();
+        scenario = scenarioDirectory.lexically_normal().generic_wstring();
+        inputHash = cache.hashRegressionInputs(scenarioDirectory);
+        if (cache.hasPassed(L"regression", scenario, inputHash)) {
+            std::wcout << L"Inputs of the scenario didn't change since it passed, test result is OK (CACHED)!\n";
+            Logger::getInstance().info(L"Inputs of scenario " + scenario + L" didn't change since it passed, skipping execution.");
+            return S_OK;
+        }
+    }
+
     HRESULT result;
     try {
         tester::RegressionTester regTester(config_filepath);
@@ -153,12 +561,51 @@ HRESULT execute_regression_testing(const std::wstring& config_filepath) {
 
     /// Moving created log into tmp
     moveToTmp(Narrow_WChar(cnst::LOG_FILE));
+    cache.record(L"regression", scenario, inputHash, result);
 
     Logger::getInstance().info(L"Shutting down.");
     std::wcerr << L"For detailed information see generated log.\n";
     return result;
 }
 
+/**
+ * Executes regression tests of every configuration file in given directory and its subdirectories,
+ * which is selected by TestSelection.
+ *
+ * @param directory directory with scenarios
+ * @return S_OK if all executed tests passed, else E_FAIL
+ */
+HRESULT execute_regression_suite(const filesystem::path& directory) {
+    std::vector<filesystem::path> configs;
+    for (const auto& entry : filesystem::recursive_directory_iterator(directory)) {
+        if (entry.is_regular_file() && entry.path().filename() == cnst::CONFIG_FILE) {
+            configs.push_back(entry.path());
+        }
+    }
+    std::sort(configs.begin(), configs.end());
+
+    HRESULT result = S_OK;
+    size_t executed = 0;
+    for (const auto& config : configs) {
+        std::wstring scenario = config.parent_path().lexically_relative(directory).generic_wstring();
+        if (!tester::TestSelection::getInstance().isSelected(L"regression", scenario)) {
+            Logger::getInstance().debug(L"Skipping scenario " + scenario + L", it is not selected.");
+            continue;
+        }
+
+        std::wcout << L"Executing scenario " << scenario << L"...\n";
+        Logger::getInstance().info(L"Executing scenario " + scenario + L"...");
+        if (execute_regression_testing(config.wstring()) != S_OK) {
+            result = E_FAIL;
+        }
+        executed++;
+    }
+
+    std::wcout << L"Executed " << executed << L" of " << configs.size() << L" scenarios.\n";
+    Logger::getInstance().info(L"Executed " + std::to_wstring(executed) + L" of " + std::to_wstring(configs.size()) + L" scenarios.");
+    return result;
+}
+
 /**
     Entry point of the application.
 */
@@ -173,23 +620,64 @@ int main(int argc, char* argv[]) {
     }
 
     if (argv[1][0] == '-') {
-        std::string parameter;
+        TExecution_Options options = parse_options(argc, argv);
         std::wstring config_filepath;
+        HRESULT result;
 
         switch (argv[1][1]) {
         case 'u':   /// unit testing
-            if (argv[2] != nullptr) {
-                parameter = argv[2];
-            }
             Logger::getInstance().info(L"Unit tests will be executed.");
             std::wcout << L"Executing unit tests.\n";
-            execute_unit_testing(parameter);
+            execute_unit_testing(options);
             break;
+        case 'p':   /// filter benchmark
+            Logger::getInstance().info(L"Filter benchmark will be executed.");
+            std::wcout << L"Executing filter benchmark.\n";
+            return execute_benchmark(options);
+        case 'b':   /// filter chain benchmark
+            Logger::getInstance().info(L"Filter chain benchmark will be executed.");
+            std::wcout << L"Executing filter chain benchmark.\n";
+            config_filepath = std::wstring{ options.subject.begin(), options.subject.end() };
+            if (config_filepath.empty()) {
+                std::wcerr << L"Missing configuration file of the benchmarked chain!\n";
+                Logger::getInstance().error(L"Missing configuration file of the benchmarked chain!");
+                return 2;
+            }
+            {
+                tester::ChainBenchmark benchmark(config_filepath);
+                if (options.generate) {
+                    benchmark.setGeneratedEvents(options.eventCount, options.generator);
+                }
+                return benchmark.execute(options.runs);
+            }
+        case 'l':   /// log scanning benchmark
+            Logger::getInstance().info(L"Log scanning benchmark will be executed.");
+            std::wcout << L"Executing log scanning benchmark.\n";
+            if (options.subject.empty()) {
+                std::wcerr << L"Missing the scanned log file!\n";
+                Logger::getInstance().error(L"Missing the scanned log file!");
+                return 2;
+            }
+            return tester::ScanBenchmark(options.subject).execute(options.runs);
+        case 's':   /// soak test
+            Logger::getInstance().info(L"Soak test will be executed.");
+            std::wcout << L"Executing soak test.\n";
+            result = execute_soak_test(options);
+            if (options.auditEvents) {
+                tester::EventAuditor::getInstance().printSummary(std::wcout);
+            }
+            return result;
         case 'r':   /// regression testing
             Logger::getInstance().info(L"Regression tests will be executed.");
             std::wcout << L"Executing regression tests.\n";
-            config_filepath = argc > 2 ? std::wstring{ argv[2], argv[2] + strlen(argv[2]) } : std::wstring{};
-            return execute_regression_testing(config_filepath);
+            config_filepath = std::wstring{ options.subject.begin(), options.subject.end() };
+            if (!config_filepath.empty() && filesystem::is_directory(config_filepath)) {
+                result = execute_regression_suite(config_filepath);
+            } else {
+                result = execute_regression_testing(config_filepath);
+            }
+            tester::ResultCache::getInstance().save();
+            return result;
         default:
             std::wcerr << L"Unknown type of testing requested!\n";
             Logger::getInstance().error(L"Unknown type of testing requested!");
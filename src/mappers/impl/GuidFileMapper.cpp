@@ -23,10 +23,11 @@ GuidFileMapper& GuidFileMapper::GetInstance() {
  * Returns the file name of shared library associated with given GUID.
  *
  * @param guid filter GUID
- * @return name of shared library containing implementation of filter with given GUID
+ * @return name of shared library containing implementation of filter with given GUID, nullptr if not mapped
  */
 const wchar_t* GuidFileMapper::getFileName(const GUID& guid) {
-	return guidFileMap[guid];
+	auto fileName = guidFileMap.find(guid);		/// Not inserting, testers may ask from multiple threads
+	return fileName == guidFileMap.end() ? nullptr : fileName->second;
 }
 
 /**
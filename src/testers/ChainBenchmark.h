@@ -0,0 +1,87 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_CHAINBENCHMARK_H
+#define SMARTTESTER_CHAINBENCHMARK_H
+
+#include <string>
+#include <cstdint>
+#include <rtl/hresult.h>
+#include <rtl/FilterLib.h>
+#include "../utils/Logger.h"
+#include "../utils/EventGenerator.h"
+#include "SoakTester.h"
+
+namespace tester {
+
+    /// Outcome of a single execution of benchmarked filter chain
+    struct TChain_Run {
+        /// Events which arrived at the end of the chain
+        std::uint64_t events = 0;
+        /// Time from creating the chain until it shut down, in seconds
+        double seconds = 0.0;
+    };
+
+    /**
+     * Class responsible for benchmarking of a whole filter chain loaded from a configuration file. Log filters
+     * are removed from the chain and the chain ends with an in-memory CountingFilter instead, so the measured
+     * throughput is the one of the processing filters, not of writing the log.
+     */
+    class ChainBenchmark {
+    private:
+        /// Path to the benchmarked configuration
+        std::wstring m_configFilepath;
+        /// Number of generated events executed upon the chain, 0 if the chain produces its own events
+        std::size_t m_generatedCount = 0;
+        /// Configuration of the generated event stream
+        TGenerator_Config m_generatorConfig;
+
+        /**
+         * Loads the configuration and removes the log filters from it.
+         * @param configuration receives the loaded configuration
+         * @return S_OK if the configuration was loaded
+         */
+        HRESULT loadConfiguration(scgms::SPersistent_Filter_Chain_Configuration& configuration);
+        /**
+         * Executes shut down event upon the chain, so it can be terminated.
+         * @param executor executor of the chain
+         * @return S_OK if the chain accepted the shut down event
+         */
+        static HRESULT shutDownChain(scgms::SFilter_Executor& executor);
+        /**
+         * Loads the configuration, executes the chain until it shuts down and counts the events.
+         * @param run receives the measured run
+         * @return S_OK if the chain was executed
+         */
+        HRESULT executeRun(TChain_Run& run);
+    public:
+        /**
+         * @param configFilepath path to the configuration file
+         */
+        explicit ChainBenchmark(std::wstring configFilepath);
+        /**
+         * Makes every run execute given number of events of the EventGenerator upon the chain, followed
+         * by a shut down event. Intended for chains without their own source of events.
+         * @param count number of generated events
+         * @param config configuration of the generated stream, every run starts it anew
+         */
+        void setGeneratedEvents(std::size_t count, const TGenerator_Config& config);
+        /**
+         * Executes the chain given number of times and prints events, wall time and events per second of every run
+         * and their summary.
+         *
+         * @param runs number of executions of the chain
+         * @return S_OK if all runs were executed
+         */
+        HRESULT execute(std::size_t runs);
+        /**
+         * Executes given soak test upon the chain, which ends with a CountingFilter instead of the log filters.
+         * @param soakTester soak test to execute
+         * @return S_OK if no growth of resources or latency drift was detected
+         */
+        HRESULT executeSoakTest(const SoakTester& soakTester);
+    };
+}
+
+#endif //SMARTTESTER_CHAINBENCHMARK_H
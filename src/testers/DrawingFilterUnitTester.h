@@ -41,6 +41,10 @@ namespace tester {
          * @return S_OK if the tested method returns right values, otherwise E_FAIL
          */
         HRESULT newDataAvailableTest();
+
+    protected: // protected methods
+        /// Configures the DrawingFilter's canvas, so the benchmark events are collected for drawing
+        HRESULT prepareBenchmark(GUID& signalId) override;
     };
 }
 #endif // !_DRAWING_FILTER_UNIT_TESTER_H_
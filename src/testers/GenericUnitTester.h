@@ -7,13 +7,19 @@
 #ifndef _GENERIC_UNIT_TESTER_H_
 #define _GENERIC_UNIT_TESTER_H_
 
-#include <mutex>
+#include <memory>
+#include <iostream>
 #include <functional>
-#include <condition_variable>
-#include <rtl/Dynamic_Library.h>
 #include <rtl/hresult.h>
 #include "../utils/TestFilter.h"
 #include "../utils/Logger.h"
+#include "../utils/FilterLibraryCache.h"
+#include "../utils/TestResults.h"
+#include "../utils/LatencyHistogram.h"
+#include "../utils/AllocationCounter.h"
+#include "../utils/EventGenerator.h"
+#include "../utils/EventAuditor.h"
+#include "SoakTester.h"
 #include "FilterConfiguration.h"
 
 namespace tester {
@@ -21,19 +27,64 @@ namespace tester {
      * Contains generic tests and methods, which can be applied on any filter.
      */
     class GenericUnitTester {
+    public: // public types
+        /// Where the tests are executed
+        enum class NExecution_Mode {
+            /// Worker thread of this process, a hung test can only be reported
+            In_Process,
+            /// Forked child process per test, killed when the test times out
+            Child_Process
+        };
+
+        /// Measurements of events executed by the benchmark
+        struct TBenchmark_Stats {
+            /// Latency of every Execute call in nanoseconds
+            LatencyHistogram latencies;
+            /// Number of events the filter failed to execute
+            std::size_t rejected = 0;
+            /// Heap allocations made while the filter executed the events, if they are counted
+            TAllocation_Count allocations;
+        };
+
+        /// Outcome of the stress test with one number of threads
+        struct TStress_Stats {
+            /// Time from releasing the threads until all of them finished, in seconds
+            double seconds = 0.0;
+            /// Number of events the filter failed to execute
+            std::size_t rejected = 0;
+            /// Executed events which never arrived to TestFilter
+            std::size_t lost = 0;
+            /// Extra arrivals of executed events, which arrived to TestFilter more than once
+            std::size_t duplicated = 0;
+            /// Arrived events which weren't executed by the stress test, e.g. emitted by the filter itself
+            std::size_t unexpected = 0;
+        };
+
     private: // private attributes
-        std::mutex m_testMutex;
-        std::condition_variable m_testCv;
-        HRESULT m_lastTestResult;
+        static inline NExecution_Mode s_executionMode = NExecution_Mode::In_Process;
+        /// Whether the benchmark counts heap allocations of the tested filter
+        static inline bool s_countAllocations = false;
+        /// Whether the benchmark and stress test execute events of the EventGenerator
+        static inline bool s_generateEvents = false;
+        /// Configuration of the generated event stream
+        static inline TGenerator_Config s_generatorConfig;
 
-        /// Dynamic library of the tested filter
-        CDynamic_Library m_filterLibrary;
+        /// Dynamic library of the tested filter, shared with other testers through FilterLibraryCache
+        std::shared_ptr<TFilter_Library> m_filterLibrary;
         /// Our custom filter for testing
         TestFilter m_testFilter;
         /// GUID of tested filter
         GUID m_testedGuid;
+        /// Name of the executed test, under which its events are audited
+        std::wstring m_runningTest;
+        /// Events created by the last executed test which were still alive when it ended, if they are audited
+        std::uint64_t m_aliveEvents = 0;
         /// Tested filter itself
         scgms::IFilter* m_testedFilter;
+        /// Console stream for test progress and results
+        std::wostream* m_output;
+        /// Console stream for error reports
+        std::wostream* m_errorOutput;
 
     public: // public methods
         explicit GenericUnitTester(GUID guid);
@@ -76,8 +127,62 @@ namespace tester {
          */
         HRESULT configurationTest(const tester::FilterConfig& config, HRESULT expectedResult);
         bool isFilterLoaded();
+        /**
+         * Sets where the tests of all testers are executed.
+         * @param mode execution mode
+         */
+        static void setExecutionMode(NExecution_Mode mode);
+        /**
+         * Sets whether the benchmark counts heap allocations made by the tested filter during Execute calls.
+         * Supported only where isAllocationCountingSupported returns true.
+         * @param countAllocations true to count allocations
+         */
+        static void setAllocationCounting(bool countAllocations);
+        /**
+         * Makes the benchmark additionally execute a stream of synthetic events and the stress test execute
+         * it instead of level events.
+         * @param config configuration of the generated stream, every benchmark starts it anew
+         */
+        static void setEventGenerator(const TGenerator_Config& config);
+        /**
+         * Redirects console output of this tester into given streams. Used when testers of multiple filters
+         * are executed in parallel, so their output can be printed in a stable order afterwards.
+         *
+         * @param output stream for test progress and results
+         * @param errorOutput stream for error reports
+         */
+        void setOutput(std::wostream& output, std::wostream& errorOutput);
         void executeAllTests();
         void executeGenericTests();
+        /**
+         * Measures throughput and latency of tested filter's Execute method. For every event code except shut down,
+         * given number of events is executed upon freshly loaded filter, prepared by prepareBenchmark, and the achieved
+         * events per second with mean, median, 99th and 99.9th percentile and maximum latency are printed.
+         * Creation of the events is not measured. If enabled, heap allocations per event are reported as well.
+         * If the event generator is set, the generated stream of the same length is measured too.
+         *
+         * @param eventCount number of events executed for every event code
+         * @return S_OK if the filter accepted all events, E_FAIL if it couldn't be benchmarked
+         */
+        HRESULT executeBenchmark(std::size_t eventCount);
+        /**
+         * Executes level events, or the generated stream if the event generator is set, upon one freshly loaded filter,
+         * prepared by prepareBenchmark, from K threads at once
+         * for K from one to given maximum. Prints achieved throughput, its scaling relative to a single thread
+         * and events which got lost or duplicated on their way to TestFilter, identified by their logical time.
+         * Filters serializing on internal locks don't scale with added threads.
+         *
+         * @param eventCount number of events executed with every thread count, split among the threads
+         * @param maxThreads maximum number of threads, 0 means one per hardware thread
+         * @return S_OK if no event was rejected, lost or duplicated with any thread count
+         */
+        HRESULT executeStressTest(std::size_t eventCount, unsigned int maxThreads = 0);
+        /**
+         * Executes given soak test upon one freshly loaded filter, prepared by prepareBenchmark.
+         * @param soakTester soak test to execute
+         * @return S_OK if no growth of resources or latency drift was detected
+         */
+        HRESULT executeSoakTest(const SoakTester& soakTester);
         /// Executes all tests for a specific filter. Needs to be implemented by derived class.
         virtual void executeSpecificTests() = 0;
 
@@ -86,17 +191,27 @@ namespace tester {
             Invokes test method passed as a parameter. Invoked method has to take in zero parameters and return HRESULT as a return value.
             @param testName name of the test which will be displayed in logs
             @param test method to be invoked by this method
+            @param timeout timeout of the test in milliseconds, 0 for the configured default
         */
-        void executeTest(const std::wstring& testName, const std::function<HRESULT(void)>& test);
+        void executeTest(const std::wstring& testName, const std::function<HRESULT(void)>& test, long timeout = 0);
         /**
          * Invokes test method passed as a parameter. Invoked method has to take in two parameters and return HRESULT as a return value.
          * The first parameter of invoked method is string and second one is HRESULT. Main purpose of this method is to invoke
          * configuration test method which takes in configuration string as first parameter and expected result as second parameter.
          * @param testName name of the test which will be displayed in logs
          * @param test method to be invoked by this method
+         * @param timeout timeout of the test in milliseconds, 0 for the configured default
          */
-        void executeConfigTest(const std::wstring& testName, const tester::FilterConfig& configuration, HRESULT expectedResult);
+        void executeConfigTest(const std::wstring& testName, const tester::FilterConfig& configuration, HRESULT expectedResult,
+                               long timeout = 0);
 
+        /**
+         * Prepares freshly loaded filter for the benchmark - e.g. configures it, so it processes the events the way
+         * it would in a filter chain. Tested filter stays unconfigured by default.
+         * @param signalId signal id set to benchmark events, stays Invalid_GUID if the events shouldn't carry any
+         * @return S_OK if the filter is ready for the benchmark
+         */
+        virtual HRESULT prepareBenchmark(GUID& signalId);
         /// Creates shut down event and executes it with tested filter
         HRESULT shutDownTest();
         /**
@@ -105,7 +220,9 @@ namespace tester {
          * @return configuration result
          */
         HRESULT configureFilter(const tester::FilterConfig& configuration);
-        CDynamic_Library& getFilterLib();
+        std::wostream& output();
+        std::wostream& errorOutput();
+        TFilter_Library* getFilterLib();
         TestFilter& getTestFilter();
         scgms::IFilter* getTestedFilter();
 
@@ -114,10 +231,82 @@ namespace tester {
         void loadFilter();
         void loadFilterLibrary();
         const wchar_t* getFilterName();
-        HRESULT runTestInThread(const std::function<HRESULT(void)>& test);
-        HRESULT runConfigTestInThread(const tester::FilterConfig& configuration, HRESULT expectedResult);
-        void runTest(const std::function<HRESULT(void)>& test);
-        void runConfigTest(const tester::FilterConfig& configuration, HRESULT expectedResult);
+        /// Returns the name under which results of this tester are reported
+        std::wstring getSuiteName();
+        /**
+         * Executes given test in the configured execution mode, prints its result and records it
+         * into the ResultCollector.
+         * @param testName name of the test which will be displayed in logs and reports
+         * @param test test to execute, already bound to its arguments
+         * @param shutDownOnTimeout whether the tested filter should be shut down when the test times out in-process
+         * @param requestedTimeout timeout requested by the test in milliseconds, the TimeoutPolicy decides the final one
+         */
+        void executeTestCase(const std::wstring& testName, const std::function<HRESULT(void)>& test, bool shutDownOnTimeout,
+                             long requestedTimeout);
+        /**
+         * Executes given test upon freshly loaded filter in the shared worker pool and waits for its result
+         * at most given timeout.
+         * @param test test to execute, already bound to its arguments
+         * @param shutDownOnTimeout whether the tested filter should be shut down when the test times out
+         * @param timeout timeout of the test in milliseconds
+         * @param testResult record of the test, receives the consumed resources and abnormal end
+         * @return result of the test, E_FAIL if it timed out
+         */
+        HRESULT runTestInPool(const std::function<HRESULT(void)>& test, bool shutDownOnTimeout, long timeout,
+                              TTest_Result& testResult);
+        /**
+         * Executes given test upon freshly loaded filter in a forked child process, which is killed
+         * if it doesn't finish within given timeout.
+         * @param test test to execute, already bound to its arguments
+         * @param timeout timeout of the test in milliseconds
+         * @param testResult record of the test, receives the consumed resources and abnormal end
+         * @return result of the test, E_FAIL if it timed out or crashed
+         */
+        HRESULT runTestInChildProcess(const std::function<HRESULT(void)>& test, long timeout, TTest_Result& testResult);
+        /**
+         * Executes given test upon the tested filter, loading it first if needed, and shuts the filter down.
+         * If the EventAuditor is enabled, events created during the test are audited under the name of the running test.
+         * @param test test to execute, already bound to its arguments
+         * @return result of the test
+         */
+        HRESULT runTest(const std::function<HRESULT(void)>& test);
+        /**
+         * Executes given number of events with given code upon the tested filter and measures latency of every
+         * call of its Execute method.
+         * @param eventCode code of executed events
+         * @param eventCount number of executed events
+         * @param stats receives latency of every Execute call, rejected events and counted allocations
+         * @return S_OK if all events were executed, E_FAIL if the benchmark couldn't be finished
+         */
+        HRESULT benchmarkEvents(scgms::NDevice_Event_Code eventCode, std::size_t eventCount, TBenchmark_Stats& stats);
+        /**
+         * Executes given number of events of the configured event generator upon the tested filter and measures
+         * latency of every call of its Execute method.
+         * @param eventCount number of executed events
+         * @param stats receives latency of every Execute call, rejected events and counted allocations
+         * @return S_OK if all events were executed, E_FAIL if the benchmark couldn't be finished
+         */
+        HRESULT benchmarkGeneratedEvents(std::size_t eventCount, TBenchmark_Stats& stats);
+        /**
+         * Executes events created in batches by given function upon the tested filter and measures latency of every
+         * call of its Execute method. Creation of the batches is not measured.
+         * @param createBatch creates given number of events, returns empty vector if they couldn't be created
+         * @param eventCount number of executed events
+         * @param stats receives latency of every Execute call, rejected events and counted allocations
+         * @return S_OK if all events were executed, E_FAIL if a batch couldn't be created
+         */
+        HRESULT benchmarkBatches(const std::function<std::vector<scgms::IDevice_Event*>(std::size_t)>& createBatch,
+                                 std::size_t eventCount, TBenchmark_Stats& stats);
+        /**
+         * Executes given number of level events, or generated events if the event generator is set, upon the tested
+         * filter from given number of threads at once
+         * and checks which of them arrived to TestFilter.
+         * @param threadCount number of threads executing the events
+         * @param eventCount number of executed events, split among the threads
+         * @param stats receives the measured time and event accounting
+         * @return S_OK if the stress test was executed, E_FAIL if it couldn't be prepared
+         */
+        HRESULT stressEvents(unsigned int threadCount, std::size_t eventCount, TStress_Stats& stats);
     };
 }
 
@@ -57,6 +57,10 @@ namespace tester {
          * @return S_OK if three log records are returned from the Pop method, otherwise E_FAIL
          */
         HRESULT popEventCountTest();
+
+    protected: // protected methods
+        /// Configures the LogFilter to log the benchmark events into a file in the tmp directory
+        HRESULT prepareBenchmark(GUID& signalId) override;
     };
 }
 #endif // !_LOG_FILTER_UNIT_TESTER_H_
@@ -62,6 +62,10 @@ namespace tester {
          */
         HRESULT allSourceIdTest();
 
+    protected: // protected methods
+        /// Configures the MappingFilter, so every benchmark event is mapped
+        HRESULT prepareBenchmark(GUID& signalId) override;
+
     private: // private methods
         HRESULT eventMappingTest(const tester::MappingFilterConfig &config, scgms::NDevice_Event_Code eventCode, const GUID& signalId = Invalid_GUID);
     };
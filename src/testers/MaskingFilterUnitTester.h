@@ -29,6 +29,10 @@ namespace tester {
          */
         HRESULT infoEventMaskingTest();
 
+    protected: // protected methods
+        /// Configures the MaskingFilter, so the benchmark level events are subject to masking
+        HRESULT prepareBenchmark(GUID& signalId) override;
+
     private: // private methods
         HRESULT bitmaskMappingTest(const GUID& signalId, const std::string &bitmask);
     };
@@ -30,7 +30,8 @@ namespace tester {
          */
         explicit RegressionTester(std::wstring config_filepath);
         /**
-         * Compares generated log with reference log on given path.
+         * Compares generated log with reference log on given path. Numeric columns are compared with the tolerances
+         * defined in cnst::TOLERANCE_FILE next to the reference log, if there is one.
          *
          * @param referenceLog path to reference log
          * @return result of regression test
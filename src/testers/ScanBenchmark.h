@@ -0,0 +1,42 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_SCANBENCHMARK_H
+#define SMARTTESTER_SCANBENCHMARK_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <rtl/hresult.h>
+
+namespace tester {
+
+    /**
+     * Microbenchmark of finding separators and line breaks in a log file. Compares the std::string::find loop
+     * the log parsing used to be built on with the DelimiterScanner executed with every instruction set
+     * available on this CPU, and checks that all of them find the same positions.
+     */
+    class ScanBenchmark {
+    private:
+        /// Path to the scanned log
+        std::string m_logPath;
+
+        /// Finds the separators and line breaks by std::string::find, the way the log was tokenized before
+        static void scanByFind(const std::string& text, std::vector<std::uint32_t>& positions);
+    public:
+        /**
+         * @param logPath path to the scanned log
+         */
+        explicit ScanBenchmark(std::string logPath);
+        /**
+         * Scans the log given number of times by every method and prints the best throughput of each.
+         * @param runs number of scans by each method
+         * @return S_OK if the log was read and all methods found the same positions
+         */
+        HRESULT execute(std::size_t runs);
+    };
+}
+
+#endif //SMARTTESTER_SCANBENCHMARK_H
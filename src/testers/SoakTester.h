@@ -0,0 +1,80 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_SOAKTESTER_H
+#define SMARTTESTER_SOAKTESTER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <rtl/hresult.h>
+#include <iface/FilterIface.h>
+#include "../utils/EventGenerator.h"
+#include "../utils/ResourceMeter.h"
+
+namespace tester {
+
+    /// Parameters of the soak test
+    struct TSoak_Options {
+        /// Duration of the soak test in seconds
+        double duration = 60.0;
+        /// Number of events executed per second
+        double rate = 1000.0;
+        /// Time between two samples in seconds
+        double interval = 10.0;
+    };
+
+    /// Measurements of one sampling interval of the soak test
+    struct TSoak_Sample {
+        /// Time since the start of the soak test, in seconds
+        double elapsed = 0.0;
+        /// Events executed during the interval
+        std::uint64_t events = 0;
+        /// Events the target failed to execute during the interval
+        std::uint64_t rejected = 0;
+        /// Achieved rate during the interval, in events per second
+        double rate = 0.0;
+        /// Latency percentiles of Execute calls during the interval, in nanoseconds
+        std::uint64_t p50 = 0;
+        std::uint64_t p99 = 0;
+        std::uint64_t max = 0;
+        /// Resource usage of the process at the end of the interval
+        TProcess_Usage usage;
+    };
+
+    /**
+     * Executes a steady rate of generated events upon a filter or a filter chain for a long time. At every interval
+     * the latency percentiles, RSS and open file descriptors are sampled, and at the end their series are checked
+     * for monotonic growth or drift, which reveals slow leaks never seen by the short unit tests.
+     * The first interval is considered a warm-up and isn't checked.
+     */
+    class SoakTester {
+    private:
+        TSoak_Options m_options;
+        TGenerator_Config m_generatorConfig;
+
+        /// Prints one sample as a row of the soak table and logs it
+        static void printSample(std::wostream& output, const TSoak_Sample& sample);
+        /**
+         * Checks the samples for growing memory or open files and for drifting latency and prints the verdict.
+         * @param output stream the verdict is printed into
+         * @param samples all samples of the soak test
+         * @return true if nothing grows or drifts
+         */
+        static bool checkDrift(std::wostream& output, const std::vector<TSoak_Sample>& samples);
+    public:
+        SoakTester(const TSoak_Options& options, const TGenerator_Config& generatorConfig);
+        /**
+         * Executes the soak test upon given target.
+         * @param target filter or filter chain executing the events
+         * @param name name of the target shown in the output
+         * @param output stream the samples and the verdict are printed into
+         * @return S_OK if nothing grew or drifted, E_FAIL otherwise or if the events couldn't be created
+         */
+        HRESULT execute(scgms::IFilter* target, const std::wstring& name, std::wostream& output) const;
+    };
+}
+
+#endif //SMARTTESTER_SOAKTESTER_H
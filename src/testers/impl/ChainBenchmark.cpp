@@ -0,0 +1,190 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <chrono>
+#include <vector>
+#include <utility>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <rtl/FilterLib.h>
+#include <rtl/hresult.h>
+#include <utils/string_utils.h>
+#include "../ChainBenchmark.h"
+#include "../../utils/CountingFilter.h"
+#include "../../utils/constants.h"
+#include "../../utils/LogUtils.h"
+#include "../../utils/scgmsLibUtils.h"
+
+namespace tester {
+
+    ChainBenchmark::ChainBenchmark(std::wstring configFilepath) : m_configFilepath(std::move(configFilepath)) {
+        //
+    }
+
+    void ChainBenchmark::setGeneratedEvents(const std::size_t count, const TGenerator_Config& config) {
+        m_generatedCount = count;
+        m_generatorConfig = config;
+    }
+
+    HRESULT ChainBenchmark::loadConfiguration(scgms::SPersistent_Filter_Chain_Configuration& configuration) {
+        refcnt::Swstr_list errors;
+        if (!configuration) {
+            Logger::getInstance().error(L"Error creating configuration instance!");
+            return E_FAIL;
+        }
+
+        HRESULT rc = configuration->Load_From_File(m_configFilepath.c_str(), errors.get());
+        log::printAndEmptyErrors(errors);
+        if (!Succeeded(rc)) {
+            std::wcerr << L"Cannot load the configuration file " << m_configFilepath << std::endl;
+            Logger::getInstance().error(L"Cannot load the configuration file " + m_configFilepath);
+            return E_FAIL;
+        }
+
+        /// Removing the log filters from the end, so indices of the remaining links don't change
+        scgms::IFilter_Configuration_Link** begin, ** end;
+        configuration->get(&begin, &end);
+        for (std::size_t i = end - begin; i > 0; i--) {
+            GUID filterId;
+            if (Succeeded(begin[i - 1]->Get_Filter_Id(&filterId)) && filterId == cnst::LOG_GUID) {
+                configuration->remove(i - 1);
+                Logger::getInstance().debug(L"Log filter removed from the benchmarked chain.");
+            }
+        }
+
+        return S_OK;
+    }
+
+    HRESULT ChainBenchmark::shutDownChain(scgms::SFilter_Executor& executor) {
+        scgms::IDevice_Event* shutDown = createEvent(scgms::NDevice_Event_Code::Shut_Down);
+        if (shutDown == nullptr || !Succeeded(executor->Execute(shutDown))) {
+            Logger::getInstance().error(L"Couldn't shut down the chain!");
+            if (shutDown != nullptr) {
+                shutDown->Release();
+            }
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    HRESULT ChainBenchmark::executeRun(TChain_Run& run) {
+        scgms::SPersistent_Filter_Chain_Configuration configuration;
+        if (loadConfiguration(configuration) != S_OK) {
+            return E_FAIL;
+        }
+
+        refcnt::Swstr_list errors;
+        CountingFilter sink;
+        const auto start = std::chrono::steady_clock::now();
+        {
+            scgms::SFilter_Executor executor{ configuration.get(), nullptr, nullptr, errors, &sink };
+            log::printAndEmptyErrors(errors);
+            if (!executor) {
+                std::wcerr << L"Could not execute the filters!" << std::endl;
+                Logger::getInstance().error(L"Could not execute the filters!");
+                return E_FAIL;
+            }
+
+            if (m_generatedCount > 0) {
+                std::size_t rejected = 0;
+                EventGenerator generator(m_generatorConfig);
+                if (generator.drive(executor.get(), m_generatedCount, rejected) != S_OK) {
+                    Logger::getInstance().error(L"Error while generating events!");
+                }
+                if (rejected > 0) {
+                    Logger::getInstance().warn(std::to_wstring(rejected) + L" generated events were rejected by the chain!");
+                }
+
+                if (shutDownChain(executor) != S_OK) {
+                    executor->Terminate(FALSE);
+                    return E_FAIL;
+                }
+            }
+
+            executor->Terminate(TRUE);  /// Waits until the chain shuts down
+        }
+
+        run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        run.events = sink.getTotal();
+        return S_OK;
+    }
+
+    HRESULT ChainBenchmark::execute(const std::size_t runs) {
+        std::wcout << L"Benchmarking filter chain " << m_configFilepath << L" (" << runs << L" runs):\n"
+                   << std::setw(6) << L"run" << std::setw(14) << L"events" << std::setw(12) << L"wall s"
+                   << std::setw(14) << L"events/s" << L"\n";
+        Logger::getInstance().info(L"Benchmarking filter chain " + m_configFilepath + L"...");
+
+        std::vector<TChain_Run> measured;
+        for (std::size_t i = 0; i < runs; i++) {
+            TChain_Run run;
+            if (executeRun(run) != S_OK) {
+                return E_FAIL;
+            }
+
+            const double eventsPerSecond = run.seconds > 0.0 ? run.events / run.seconds : 0.0;
+            std::wcout << std::setw(6) << (i + 1) << std::setw(14) << run.events
+                       << std::fixed << std::setprecision(3) << std::setw(12) << run.seconds
+                       << std::setprecision(0) << std::setw(14) << eventsPerSecond
+                       << std::defaultfloat << std::setprecision(6) << L"\n";
+            Logger::getInstance().info(L"Run " + std::to_wstring(i + 1) + L": " + std::to_wstring(run.events) + L" events in "
+                                       + std::to_wstring(run.seconds) + L" s, " + std::to_wstring(eventsPerSecond) + L" events/s");
+            measured.push_back(run);
+        }
+
+        if (measured.empty()) {
+            return S_OK;
+        }
+
+        std::sort(measured.begin(), measured.end(), [](const TChain_Run& first, const TChain_Run& second) {
+            return first.seconds < second.seconds;
+        });
+
+        std::uint64_t totalEvents = 0;
+        double totalSeconds = 0.0;
+        for (const TChain_Run& run : measured) {
+            totalEvents += run.events;
+            totalSeconds += run.seconds;
+        }
+        const double median = measured[measured.size() / 2].seconds;
+
+        std::wcout << L"Total " << totalEvents << L" events in " << std::fixed << std::setprecision(3) << totalSeconds
+                   << L" s, " << std::setprecision(0) << (totalSeconds > 0.0 ? totalEvents / totalSeconds : 0.0)
+                   << L" events/s; wall time min " << std::setprecision(3) << measured.front().seconds
+                   << L" s, median " << median << L" s, max " << measured.back().seconds << L" s\n"
+                   << std::defaultfloat << std::setprecision(6);
+        Logger::getInstance().info(L"Total " + std::to_wstring(totalEvents) + L" events in " + std::to_wstring(totalSeconds)
+                                   + L" s, median wall time " + std::to_wstring(median) + L" s");
+        return S_OK;
+    }
+
+    HRESULT ChainBenchmark::executeSoakTest(const SoakTester& soakTester) {
+        scgms::SPersistent_Filter_Chain_Configuration configuration;
+        if (loadConfiguration(configuration) != S_OK) {
+            return E_FAIL;
+        }
+
+        refcnt::Swstr_list errors;
+        CountingFilter sink;
+        scgms::SFilter_Executor executor{ configuration.get(), nullptr, nullptr, errors, &sink };
+        log::printAndEmptyErrors(errors);
+        if (!executor) {
+            std::wcerr << L"Could not execute the filters!" << std::endl;
+            Logger::getInstance().error(L"Could not execute the filters!");
+            return E_FAIL;
+        }
+
+        HRESULT result = soakTester.execute(executor.get(), L"filter chain " + m_configFilepath, std::wcout);
+        if (shutDownChain(executor) != S_OK) {
+            executor->Terminate(FALSE);
+            return E_FAIL;
+        }
+
+        executor->Terminate(TRUE);  /// Waits until the chain shuts down
+        Logger::getInstance().info(std::to_wstring(sink.getTotal()) + L" events arrived at the end of the chain.");
+        return result;
+    }
+}
@@ -90,14 +90,17 @@ namespace tester {
         moveToTmp(TEST_IMAGE_2_SVG);
 
         /// Functional tests
-        executeTest(L"image generation test", std::bind(&DrawingFilterUnitTester::imageGenerationTest, this));
+        executeTest(L"image generation test", std::bind(&DrawingFilterUnitTester::imageGenerationTest, this),
+                    cnst::DRAWING_EXEC_TIME);
         moveToTmp(DAY_IMAGE_SVG);
         moveToTmp(GRAPH_IMAGE_SVG);
 
-        executeTest(L"svg retrieving test", std::bind(&DrawingFilterUnitTester::svgRetrievingTest, this));
+        executeTest(L"svg retrieving test", std::bind(&DrawingFilterUnitTester::svgRetrievingTest, this),
+                    cnst::DRAWING_EXEC_TIME);
         moveToTmp(SVG_RETRIEVING_TEST_SVG);
 
-        executeTest(L"new data available test", std::bind(&DrawingFilterUnitTester::newDataAvailableTest, this));
+        executeTest(L"new data available test", std::bind(&DrawingFilterUnitTester::newDataAvailableTest, this),
+                    cnst::DRAWING_EXEC_TIME);
         moveToTmp(NEW_DATA_AVAILABLE_TEST_SVG);
     }
 
@@ -229,5 +232,9 @@ namespace tester {
         return S_OK;
     }
 
-
+    HRESULT DrawingFilterUnitTester::prepareBenchmark(GUID& signalId) {
+        signalId = scgms::signal_BG;
+        tester::DrawingFilterConfig config(1200, 800);
+        return configureFilter(config);
+    }
 }
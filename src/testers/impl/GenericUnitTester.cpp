@@ -1,9 +1,13 @@
 #include <iostream>
-#include <chrono>
-#include <thread>
-#include <condition_variable>
 #include <functional>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
 #include <rtl/hresult.h>
 #include <rtl/FilterLib.h>
 #include <rtl/scgmsLib.h>
@@ -12,25 +16,29 @@
 #include "../../utils/LogUtils.h"
 #include "../GenericUnitTester.h"
 #include "../../utils/scgmsLibUtils.h"
+#include "../../utils/TestWorkerPool.h"
+#include "../../utils/ChildProcess.h"
+#include "../../utils/TimeoutPolicy.h"
+#include "../../utils/TestSelection.h"
+#include "../../utils/ResultCache.h"
 
 namespace tester {
 
     GenericUnitTester::GenericUnitTester(const GUID guid)
-            :  m_lastTestResult(S_OK), m_testedGuid(guid), m_testedFilter(nullptr) {
+            :  m_testedGuid(guid), m_testedFilter(nullptr), m_output(&std::wcout), m_errorOutput(&std::wcerr) {
         //
     }
 
     void GenericUnitTester::loadFilter() {
-        if (!m_filterLibrary.Is_Loaded()) {
-            std::wcerr << L"Filter library is not loaded! Filter will not be loaded.\n";
+        if (!m_filterLibrary) {
+            errorOutput() << L"Filter library is not loaded! Filter will not be loaded.\n";
             Logger::getInstance().error(L"Filter library is not loaded! Filter will not be loaded.");
             return;
         }
 
-        auto creator = m_filterLibrary.Resolve<scgms::TCreate_Filter>("do_create_filter");
-
         m_testedFilter = nullptr;
-        auto result = creator(&m_testedGuid, &m_testFilter, &m_testedFilter);
+        m_testFilter.reset();       /// Every test inspects only events emitted by its own filter
+        auto result = m_filterLibrary->createFilter(&m_testedGuid, &m_testFilter, &m_testedFilter);
         if (result != S_OK) {
             Logger::getInstance().error(L"Error while loading filter from the dynamic library!");
             m_testedFilter = nullptr;   /// Just to be sure
@@ -41,13 +49,16 @@ namespace tester {
 
 
     const wchar_t* GenericUnitTester::getFilterName() {
-        if (!m_filterLibrary.Is_Loaded()) {
+        if (!m_filterLibrary) {
             loadFilterLibrary();
         }
 
-        auto creator = m_filterLibrary.Resolve<scgms::TGet_Filter_Descriptors>("do_get_filter_descriptors");
+        if (!m_filterLibrary) {
+            return L"<unknown>";
+        }
+
         scgms::TFilter_Descriptor* begin, * end;
-        creator(&begin, &end);
+        m_filterLibrary->getFilterDescriptors(&begin, &end);
         for (int i = 0; i < (end - begin); i++) {
             if (begin->id == m_testedGuid) {
                 return begin->description;
@@ -58,12 +69,17 @@ namespace tester {
         return nullptr;
     }
 
+    std::wstring GenericUnitTester::getSuiteName() {
+        const wchar_t* filter_name = getFilterName();
+        return filter_name ? std::wstring(filter_name) : GUID_To_WString(m_testedGuid);
+    }
+
     void GenericUnitTester::executeAllTests() {
         const wchar_t* filter_name = getFilterName();
 
-        std::wcout << "****************************************\n"
-                   << "Testing " << filter_name << " filter:\n"
-                   << "****************************************\n";
+        output() << "****************************************\n"
+                 << "Testing " << filter_name << " filter:\n"
+                 << "****************************************\n";
         Logger::getInstance().debug(L"****************************************");
         Logger::getInstance().debug(L"Testing " + std::wstring(filter_name) + L" filter:");
         Logger::getInstance().debug(L"****************************************");
@@ -82,134 +98,526 @@ namespace tester {
         executeTest(L"shut down event test", std::bind(&GenericUnitTester::shutDownEventTest, this));
     }
 
-    void GenericUnitTester::executeTest(const std::wstring& testName, const std::function<HRESULT(void)>& test) {
-        Logger::getInstance().info(L"----------------------------------------");
-        Logger::getInstance().info(L"Executing " + testName + L"...");
-        Logger::getInstance().info(L"----------------------------------------");
-        std::wcout << "Executing " << testName << "... ";
-        HRESULT result = runTestInThread(test);
-        log::printResult(result);
+    void GenericUnitTester::executeTest(const std::wstring& testName, const std::function<HRESULT(void)>& test,
+                                        const long timeout) {
+        executeTestCase(testName, test, false, timeout);
+    }
+
+    void GenericUnitTester::executeConfigTest(const std::wstring& testName, const tester::FilterConfig& configuration,
+                                              const HRESULT expectedResult, const long timeout) {
+        executeTestCase(testName, std::bind(&GenericUnitTester::configurationTest, this, std::cref(configuration), expectedResult),
+                        true, timeout);
     }
 
-    void GenericUnitTester::executeConfigTest(const std::wstring& testName, const tester::FilterConfig& configuration, const HRESULT expectedResult) {
+    void GenericUnitTester::executeTestCase(const std::wstring& testName, const std::function<HRESULT(void)>& test,
+                                            const bool shutDownOnTimeout, const long requestedTimeout) {
+        const std::wstring suite = getSuiteName();
+        if (!TestSelection::getInstance().isSelected(suite, testName)) {
+            Logger::getInstance().debug(L"Skipping " + testName + L", test is not selected.");
+            return;
+        }
+
         Logger::getInstance().info(L"----------------------------------------");
         Logger::getInstance().info(L"Executing " + testName + L"...");
         Logger::getInstance().info(L"----------------------------------------");
-        std::wcout << "Executing " << testName << "... ";
-        HRESULT result = runConfigTestInThread(configuration, expectedResult);
-        log::printResult(result);
+        output() << "Executing " << testName << "... ";
+
+        TTest_Result testResult;
+        testResult.suite = suite;
+        testResult.name = testName;
+
+        ResultCache& cache = ResultCache::getInstance();
+        std::uint64_t inputHash = 0;
+        if (cache.isEnabled()) {
+            const wchar_t* libraryFile = GuidFileMapper::GetInstance().getFileName(m_testedGuid);
+            inputHash = cache.hashUnitInputs(libraryFile ? std::wstring(libraryFile) + cnst::LIB_EXTENSION : L"");
+            if (cache.hasPassed(suite, testName, inputHash)) {
+                Logger::getInstance().info(L"Inputs of the test didn't change since it passed, skipping execution.");
+                output() << "CACHED ";
+                testResult.result = S_OK;
+                testResult.cached = true;
+                log::printResult(testResult.result, output(), errorOutput());
+                ResultCollector::getInstance().add(testResult);
+                return;
+            }
+        }
+
+        m_runningTest = testName;
+        m_aliveEvents = 0;
+        long timeout = TimeoutPolicy::getInstance().getTimeout(testResult.suite, testName, requestedTimeout);
+        Logger::getInstance().debug(L"Test timeout: " + std::to_wstring(timeout) + L" ms");
+        if (s_executionMode == NExecution_Mode::Child_Process) {
+            testResult.result = runTestInChildProcess(test, timeout, testResult);
+        } else {
+            testResult.result = runTestInPool(test, shutDownOnTimeout, timeout, testResult);
+        }
+
+        log::printResult(testResult.result, output(), errorOutput());
+        if (m_aliveEvents > 0) {
+            errorOutput() << L"    " << m_aliveEvents << L" events created by the test are still alive!\n";
+        }
+        cache.record(suite, testName, inputHash, testResult.result);
+        ResultCollector::getInstance().add(testResult);
     }
 
-    HRESULT GenericUnitTester::shutDownTest() {
-        if (!isFilterLoaded()) {
-            return E_FAIL;
+    /// Prints one row of the benchmark table and logs it
+    static void printBenchmarkRow(std::wostream& output, const std::wstring& label,
+                                  const GenericUnitTester::TBenchmark_Stats& stats, const bool countAllocations) {
+        const LatencyHistogram& latencies = stats.latencies;
+        const double seconds = latencies.getTotal() / 1e9;
+        const double eventsPerSecond = seconds > 0.0 ? latencies.getCount() / seconds : 0.0;
+        const double events = latencies.getCount() > 0 ? static_cast<double>(latencies.getCount()) : 1.0;
+
+        output << std::left << std::setw(34) << label << std::right
+               << std::fixed << std::setprecision(0) << std::setw(12) << eventsPerSecond
+               << std::setprecision(1) << std::setw(10) << latencies.getMean()
+               << std::setw(10) << latencies.getPercentile(50.0)
+               << std::setw(10) << latencies.getPercentile(99.0)
+               << std::setw(10) << latencies.getPercentile(99.9)
+               << std::setw(12) << latencies.getMax();
+        if (countAllocations) {
+            output << std::setprecision(2) << std::setw(12) << stats.allocations.allocations / events
+                   << std::setprecision(1) << std::setw(12) << stats.allocations.bytes / events;
+        }
+        if (stats.rejected > 0) {
+            output << "  (" << stats.rejected << " rejected)";
         }
+        output << "\n" << std::defaultfloat << std::setprecision(6);
+
+        std::wstring logged = label + L": " + std::to_wstring(eventsPerSecond) + L" events/s, mean "
+                              + std::to_wstring(latencies.getMean()) + L" ns, p50 "
+                              + std::to_wstring(latencies.getPercentile(50.0)) + L" ns, p99 "
+                              + std::to_wstring(latencies.getPercentile(99.0)) + L" ns, p99.9 "
+                              + std::to_wstring(latencies.getPercentile(99.9)) + L" ns, max "
+                              + std::to_wstring(latencies.getMax()) + L" ns, "
+                              + std::to_wstring(stats.rejected) + L" rejected";
+        if (countAllocations) {
+            logged += L", " + std::to_wstring(stats.allocations.allocations / events) + L" allocations/event, "
+                      + std::to_wstring(stats.allocations.bytes / events) + L" bytes/event";
+        }
+        Logger::getInstance().info(logged);
+    }
 
-        scgms::IDevice_Event* shutDown = createEvent(scgms::NDevice_Event_Code::Shut_Down);
-        if (shutDown == nullptr) {
-            std::wcerr << L"Error while creating " << describeEvent(scgms::NDevice_Event_Code::Shut_Down) << std::endl;
-            Logger::getInstance().error(L"Error while creating " + describeEvent(scgms::NDevice_Event_Code::Shut_Down));
-            return E_FAIL;
+    HRESULT GenericUnitTester::executeBenchmark(const std::size_t eventCount) {
+        const wchar_t* filter_name = getFilterName();
+        if (filter_name == nullptr) {
+            filter_name = L"<unknown>";
         }
 
-        m_testedFilter->Execute(shutDown);
-        m_testedFilter->Release();
-        m_testedFilter = nullptr;
+        output() << "****************************************\n"
+                 << "Benchmarking " << filter_name << " filter (" << eventCount << " events per event code):\n"
+                 << "****************************************\n"
+                 << std::left << std::setw(34) << "event" << std::right << std::setw(12) << "events/s"
+                 << std::setw(10) << "mean ns" << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns"
+                 << std::setw(10) << "p99.9 ns" << std::setw(12) << "max ns";
+        if (s_countAllocations) {
+            output() << std::setw(12) << "allocs/evt" << std::setw(12) << "bytes/evt";
+        }
+        output() << "\n";
+        Logger::getInstance().info(L"Benchmarking " + std::wstring(filter_name) + L" filter...");
+
+        HRESULT result = S_OK;
+        TBenchmark_Stats allStats;
+        for (std::size_t code = static_cast<std::size_t>(scgms::NDevice_Event_Code::Nothing);
+             code < static_cast<std::size_t>(scgms::NDevice_Event_Code::count); code++) {
+            const auto eventCode = static_cast<scgms::NDevice_Event_Code>(code);
+            if (eventCode == scgms::NDevice_Event_Code::Shut_Down) {   /// Filter doesn't accept anything after shutting down
+                continue;
+            }
+
+            TBenchmark_Stats stats;
+            m_runningTest = L"benchmark of " + describeEvent(eventCode);
+            HRESULT benchmarkResult = runTest([this, eventCode, eventCount, &stats]() {
+                return benchmarkEvents(eventCode, eventCount, stats);
+            });
+
+            if (!Succeeded(benchmarkResult)) {
+                output() << std::left << std::setw(34) << describeEvent(eventCode) << std::right << "ERROR!\n";
+                result = E_FAIL;
+                continue;
+            }
 
+            printBenchmarkRow(output(), describeEvent(eventCode), stats, s_countAllocations);
+            allStats.latencies.merge(stats.latencies);
+            allStats.rejected += stats.rejected;
+            allStats.allocations.allocations += stats.allocations.allocations;
+            allStats.allocations.bytes += stats.allocations.bytes;
+            if (stats.rejected > 0) {
+                result = E_FAIL;
+            }
+        }
+
+        printBenchmarkRow(output(), L"All events", allStats, s_countAllocations);
+
+        if (s_generateEvents) {
+            TBenchmark_Stats stats;
+            m_runningTest = L"benchmark of generated stream";
+            HRESULT benchmarkResult = runTest([this, eventCount, &stats]() {
+                return benchmarkGeneratedEvents(eventCount, stats);
+            });
+
+            if (!Succeeded(benchmarkResult)) {
+                output() << std::left << std::setw(34) << L"Generated stream" << std::right << "ERROR!\n";
+                return E_FAIL;
+            }
+
+            printBenchmarkRow(output(), L"Generated stream", stats, s_countAllocations);
+            if (stats.rejected > 0) {
+                result = E_FAIL;
+            }
+        }
+        return result;
+    }
+
+    HRESULT GenericUnitTester::executeSoakTest(const SoakTester& soakTester) {
+        const wchar_t* filter_name = getFilterName();
+        const std::wstring name = std::wstring(filter_name == nullptr ? L"<unknown>" : filter_name) + L" filter";
+
+        m_runningTest = L"soak test";
+        return runTest([this, &soakTester, &name]() {
+            GUID signalId = Invalid_GUID;   /// Generated events carry their own signal ids
+            if (!Succeeded(prepareBenchmark(signalId))) {
+                Logger::getInstance().error(L"Couldn't prepare filter for the soak test!");
+                return E_FAIL;
+            }
+
+            return soakTester.execute(m_testedFilter, name, output());
+        });
+    }
+
+    HRESULT GenericUnitTester::prepareBenchmark(GUID& signalId) {
         return S_OK;
     }
 
-    HRESULT GenericUnitTester::runTestInThread(const std::function<HRESULT(void)>& test) {
-        Logger::getInstance().debug(L"Running test in thread...");
-        std::cv_status status;
-        HRESULT result;
+    HRESULT GenericUnitTester::benchmarkEvents(const scgms::NDevice_Event_Code eventCode, const std::size_t eventCount,
+                                               TBenchmark_Stats& stats) {
+        GUID signalId = Invalid_GUID;
+        HRESULT prepareResult = prepareBenchmark(signalId);
+        if (!Succeeded(prepareResult)) {
+            Logger::getInstance().error(L"Couldn't prepare filter for the benchmark!");
+            return E_FAIL;
+        }
 
-        {
-            std::unique_lock<std::mutex> lock(m_testMutex);
+        return benchmarkBatches([eventCode, &signalId](std::size_t batchSize) {
+            std::vector<scgms::IDevice_Event*> batch = createEvents(eventCode, batchSize, signalId);
+            if (batch.empty()) {
+                Logger::getInstance().error(L"Error while creating " + describeEvent(eventCode));
+            }
+            return batch;
+        }, eventCount, stats);
+    }
 
-            std::thread thread(&GenericUnitTester::runTest, this, test);
+    HRESULT GenericUnitTester::benchmarkGeneratedEvents(const std::size_t eventCount, TBenchmark_Stats& stats) {
+        GUID signalId = Invalid_GUID;   /// Generated events carry their own signal ids
+        HRESULT prepareResult = prepareBenchmark(signalId);
+        if (!Succeeded(prepareResult)) {
+            Logger::getInstance().error(L"Couldn't prepare filter for the benchmark!");
+            return E_FAIL;
+        }
 
-            status = m_testCv.wait_for(lock, std::chrono::milliseconds(cnst::MAX_EXEC_TIME));
-            lock.unlock();
+        EventGenerator generator(s_generatorConfig);
+        return benchmarkBatches([&generator](std::size_t batchSize) {
+            std::vector<scgms::IDevice_Event*> batch = generator.generate(batchSize);
+            if (batch.empty()) {
+                Logger::getInstance().error(L"Error while generating events!");
+            }
+            return batch;
+        }, eventCount, stats);
+    }
+
+    HRESULT GenericUnitTester::benchmarkBatches(const std::function<std::vector<scgms::IDevice_Event*>(std::size_t)>& createBatch,
+                                                const std::size_t eventCount, TBenchmark_Stats& stats) {
+        /// Events are created in batches outside of the measured section, not to hold all of them in memory at once
+        constexpr std::size_t BATCH_SIZE = 4096;
+
+        for (std::size_t executed = 0; executed < eventCount; ) {
+            const std::size_t batchSize = std::min(BATCH_SIZE, eventCount - executed);
+            std::vector<scgms::IDevice_Event*> batch = createBatch(batchSize);
+            if (batch.empty()) {
+                return E_FAIL;
+            }
+            executed += batch.size();
+
+            if (s_countAllocations) {   /// Only allocations made while the filter executes the batch are counted
+                startAllocationCounting();
+            }
 
-            if (status == std::cv_status::timeout) {
-//                shutDownTest();
+            /// Every call is measured from the end of the previous one, so there's only one clock reading per event
+            auto previous = std::chrono::steady_clock::now();
+            for (scgms::IDevice_Event* event : batch) {
+                const HRESULT executeResult = m_testedFilter->Execute(event);
+                const auto now = std::chrono::steady_clock::now();
+                stats.latencies.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count()));
+                previous = now;
+
+                if (!Succeeded(executeResult)) {
+                    event->Release();   /// Not consumed by the filter
+                    stats.rejected++;
+                    previous = std::chrono::steady_clock::now();
+                }
             }
 
-            if (thread.joinable()) {
-                thread.join();
+            if (s_countAllocations) {
+                TAllocation_Count allocations = stopAllocationCounting();
+                stats.allocations.allocations += allocations.allocations;
+                stats.allocations.bytes += allocations.bytes;
             }
         }
 
-        if (status == std::cv_status::timeout) {
-            std::wcerr << L"TIMEOUT ";
-            Logger::getInstance().error(L"Test in thread timed out!");
-            result = E_FAIL;
-        } else {
-            result = m_lastTestResult;
+        return S_OK;
+    }
+
+    HRESULT GenericUnitTester::executeStressTest(const std::size_t eventCount, unsigned int maxThreads) {
+        const wchar_t* filter_name = getFilterName();
+        if (filter_name == nullptr) {
+            filter_name = L"<unknown>";
+        }
+
+        if (maxThreads == 0) {
+            maxThreads = std::max(1u, std::thread::hardware_concurrency());
         }
 
+        output() << "****************************************\n"
+                 << "Stress testing " << filter_name << " filter (" << eventCount
+                 << (s_generateEvents ? " generated" : " level") << " events per thread count):\n"
+                 << "****************************************\n"
+                 << std::setw(8) << "threads" << std::setw(14) << "events/s" << std::setw(10) << "scaling"
+                 << std::setw(10) << "rejected" << std::setw(10) << "lost" << std::setw(12) << "duplicated"
+                 << std::setw(12) << "unexpected" << "\n";
+        Logger::getInstance().info(L"Stress testing " + std::wstring(filter_name) + L" filter...");
+
+        HRESULT result = S_OK;
+        double singleThreadThroughput = 0.0;
+        for (unsigned int threadCount = 1; threadCount <= maxThreads; threadCount++) {
+            TStress_Stats stats;
+            m_runningTest = L"stress test with " + std::to_wstring(threadCount) + L" threads";
+            HRESULT stressResult = runTest([this, threadCount, eventCount, &stats]() {
+                return stressEvents(threadCount, eventCount, stats);
+            });
+
+            if (!Succeeded(stressResult)) {
+                output() << std::setw(8) << threadCount << "  ERROR!\n";
+                result = E_FAIL;
+                continue;
+            }
+
+            const double throughput = stats.seconds > 0.0 ? eventCount / stats.seconds : 0.0;
+            if (threadCount == 1) {
+                singleThreadThroughput = throughput;
+            }
+            const double scaling = singleThreadThroughput > 0.0 ? throughput / singleThreadThroughput : 0.0;
+
+            output() << std::setw(8) << threadCount << std::fixed << std::setprecision(0) << std::setw(14) << throughput
+                     << std::setprecision(2) << std::setw(10) << scaling << std::defaultfloat << std::setprecision(6)
+                     << std::setw(10) << stats.rejected << std::setw(10) << stats.lost
+                     << std::setw(12) << stats.duplicated << std::setw(12) << stats.unexpected << "\n";
+            Logger::getInstance().info(std::to_wstring(threadCount) + L" threads: " + std::to_wstring(throughput)
+                                       + L" events/s, scaling " + std::to_wstring(scaling) + L", "
+                                       + std::to_wstring(stats.rejected) + L" rejected, "
+                                       + std::to_wstring(stats.lost) + L" lost, "
+                                       + std::to_wstring(stats.duplicated) + L" duplicated, "
+                                       + std::to_wstring(stats.unexpected) + L" unexpected");
+
+            if (stats.rejected > 0 || stats.lost > 0 || stats.duplicated > 0) {
+                result = E_FAIL;
+            }
+        }
+
+        m_testFilter.reset(TestFilter::DEFAULT_CAPACITY);    /// Not keeping the enlarged buffer for other tests
         return result;
     }
 
-    HRESULT GenericUnitTester::runConfigTestInThread(const tester::FilterConfig& configuration, const HRESULT expectedResult) {
-        Logger::getInstance().debug(L"Running test in thread...");
-        std::cv_status status;
-        HRESULT result;
+    HRESULT GenericUnitTester::stressEvents(const unsigned int threadCount, const std::size_t eventCount,
+                                            TStress_Stats& stats) {
+        GUID signalId = Invalid_GUID;
+        HRESULT prepareResult = prepareBenchmark(signalId);
+        if (!Succeeded(prepareResult)) {
+            Logger::getInstance().error(L"Couldn't prepare filter for the stress test!");
+            return E_FAIL;
+        }
+
+        /// Every executed event has to fit into the buffer, with some room for events emitted by the filter itself
+        m_testFilter.reset(eventCount + eventCount / 4 + 1024);
+
+        std::vector<std::vector<scgms::IDevice_Event*>> threadEvents(threadCount);
+        std::unordered_map<std::int64_t, std::size_t> arrivals;
+        arrivals.reserve(eventCount);
+        EventGenerator generator(s_generatorConfig);
+        for (unsigned int i = 0; i < threadCount; i++) {
+            const std::size_t count = eventCount / threadCount + (i < eventCount % threadCount ? 1 : 0);
+            threadEvents[i] = s_generateEvents ? generator.generate(count)    /// Every thread executes its part of the stream
+                                               : createEvents(scgms::NDevice_Event_Code::Level, count, signalId);
+            if (threadEvents[i].size() != count) {
+                Logger::getInstance().error(L"Error while creating " + describeEvent(scgms::NDevice_Event_Code::Level));
+                for (auto& events : threadEvents) {
+                    releaseEvents(events);
+                }
+                return E_FAIL;
+            }
 
-        {
-            std::unique_lock<std::mutex> lock(m_testMutex);
+            for (scgms::IDevice_Event* event : threadEvents[i]) {   /// Logical time identifies every created event
+                scgms::TDevice_Event* raw_event;
+                event->Raw(&raw_event);
+                arrivals.emplace(raw_event->logical_time, 0);
+            }
+        }
 
-            std::thread thread(&GenericUnitTester::runConfigTest, this, std::ref(configuration), expectedResult);
+        if (arrivals.size() != eventCount) {
+            Logger::getInstance().warn(L"Created events don't have unique logical time, lost events can't be told apart!");
+        }
 
-            status = m_testCv.wait_for(lock, std::chrono::milliseconds(cnst::MAX_EXEC_TIME));
-            lock.unlock();
+        std::atomic<unsigned int> readyThreads{0};
+        std::atomic<bool> started{false};
+        /// Logical times of events rejected by the filter, per thread
+        std::vector<std::vector<std::int64_t>> rejectedEvents(threadCount);
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < threadCount; i++) {
+            threads.emplace_back([this, &events = threadEvents[i], &rejected = rejectedEvents[i], &readyThreads, &started]() {
+                readyThreads++;
+                while (!started.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+
+                for (scgms::IDevice_Event* event : events) {
+                    if (!Succeeded(m_testedFilter->Execute(event))) {
+                        scgms::TDevice_Event* raw_event;    /// Not consumed by the filter, so still valid
+                        event->Raw(&raw_event);
+                        rejected.push_back(raw_event->logical_time);
+                        event->Release();
+                    }
+                }
+            });
+        }
 
-            if (status == std::cv_status::timeout) {
-                shutDownTest();
+        while (readyThreads.load() < threadCount) {
+            std::this_thread::yield();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        started.store(true, std::memory_order_release);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (m_testFilter.getOverwrittenCount() > 0) {
+            Logger::getInstance().warn(L"TestFilter's buffer overflowed, some arrivals weren't recorded!");
+        }
+
+        for (const TestFilter::TReceived_Event& received : m_testFilter.getReceivedEvents()) {
+            auto arrival = arrivals.find(received.event.logical_time);
+            if (arrival == arrivals.end()) {
+                stats.unexpected++;
+            } else {
+                arrival->second++;
             }
+        }
 
-            if (thread.joinable()) {
-                thread.join();
+        /// Rejected events were never supposed to arrive, every other one has to arrive exactly once
+        for (const auto& rejected : rejectedEvents) {
+            stats.rejected += rejected.size();
+            for (const std::int64_t logicalTime : rejected) {
+                arrivals.erase(logicalTime);
             }
         }
 
-        if (status == std::cv_status::timeout) {
-            std::wcerr << L"TIMEOUT ";
-            Logger::getInstance().error(L"Test in thread timed out!");
-            result = E_FAIL;
-        } else {
-            result = m_lastTestResult;
+        for (const auto& arrival : arrivals) {
+            if (arrival.second == 0) {
+                stats.lost++;
+            } else {
+                stats.duplicated += arrival.second - 1;
+            }
         }
 
-        return result;
+        return S_OK;
     }
 
-    void GenericUnitTester::runTest(const std::function<HRESULT(void)>& test) {
-        if (!m_filterLibrary.Is_Loaded()) {
-            loadFilterLibrary();
-        }
+    void GenericUnitTester::setAllocationCounting(const bool countAllocations) {
+        s_countAllocations = countAllocations;
+    }
+
+    void GenericUnitTester::setEventGenerator(const TGenerator_Config& config) {
+        s_generatorConfig = config;
+        s_generateEvents = true;
+    }
 
+    HRESULT GenericUnitTester::shutDownTest() {
         if (!isFilterLoaded()) {
-            loadFilter();
+            return E_FAIL;
         }
 
-        if (isFilterLoaded()) {
-            m_lastTestResult = test();
-        } else {
-            Logger::getInstance().error(L"Filter is not loaded! Test will not be executed.");
-            m_lastTestResult = E_FAIL;
+        scgms::IDevice_Event* shutDown = createEvent(scgms::NDevice_Event_Code::Shut_Down);
+        if (shutDown == nullptr) {
+            errorOutput() << L"Error while creating " << describeEvent(scgms::NDevice_Event_Code::Shut_Down) << std::endl;
+            Logger::getInstance().error(L"Error while creating " + describeEvent(scgms::NDevice_Event_Code::Shut_Down));
+            return E_FAIL;
         }
 
-        if (isFilterLoaded()) { /// Need to check, because filter will be unloaded in case of TIMEOUT
-            shutDownTest();
+        m_testedFilter->Execute(shutDown);
+        m_testedFilter->Release();
+        m_testedFilter = nullptr;
+
+        return S_OK;
+    }
+
+    HRESULT GenericUnitTester::runTestInPool(const std::function<HRESULT(void)>& test, const bool shutDownOnTimeout,
+                                             const long timeout, TTest_Result& testResult) {
+        Logger::getInstance().debug(L"Running test in worker pool...");
+        HRESULT result;
+
+        TestWorkerPool& pool = TestWorkerPool::getInstance();
+        TestWorkerPool::TJob_Id job = pool.submit([this, &test, &testResult]() {
+            ResourceMeter meter;
+            HRESULT returned = runTest(test);
+            testResult.metrics = meter.stop();
+            return returned;
+        }, timeout);
+
+        if (pool.waitFor(job, result) == TestWorkerPool::NJob_State::Timed_Out) {
+            if (shutDownOnTimeout) {
+                shutDownTest();
+            }
+
+            pool.waitForCompletion(job);     /// The test still works with this tester's filter, can't go on without it
+
+            errorOutput() << L"TIMEOUT ";
+            Logger::getInstance().error(L"Test in thread timed out!");
+            testResult.abnormalEnd = L"TIMEOUT";
+            result = E_FAIL;
+        }
+
+        return result;
+    }
+
+    HRESULT GenericUnitTester::runTestInChildProcess(const std::function<HRESULT(void)>& test, const long timeout,
+                                                     TTest_Result& testResult) {
+        Logger::getInstance().debug(L"Running test in child process...");
+        HRESULT result = E_FAIL;
+        std::wstring description;
+
+        switch (runInChildProcess([this, &test]() { return runTest(test); }, timeout, result,
+                                  testResult.metrics, description)) {
+            case NChild_State::Finished:
+                break;
+            case NChild_State::Timed_Out:
+                errorOutput() << L"TIMEOUT ";
+                Logger::getInstance().error(L"Test in child process timed out, the process was killed!");
+                testResult.abnormalEnd = L"TIMEOUT";
+                result = E_FAIL;
+                break;
+            case NChild_State::Crashed:
+                errorOutput() << L"CRASH (" << description << L") ";
+                Logger::getInstance().error(L"Child process executing the test " + description + L"!");
+                testResult.abnormalEnd = L"CRASH (" + description + L")";
+                result = E_FAIL;
+                break;
         }
 
-        m_testCv.notify_all();
+        return result;
     }
 
-    void GenericUnitTester::runConfigTest(const tester::FilterConfig& configuration, const HRESULT expectedResult) {
-        if (!m_filterLibrary.Is_Loaded()) {
+    HRESULT GenericUnitTester::runTest(const std::function<HRESULT(void)>& test) {
+        if (!m_filterLibrary) {
             loadFilterLibrary();
         }
 
@@ -217,24 +625,46 @@ namespace tester {
             loadFilter();
         }
 
+        EventAuditor& auditor = EventAuditor::getInstance();
+        std::shared_ptr<TEvent_Audit> audit;
+        if (auditor.isEnabled()) {
+            audit = auditor.beginScope();
+        }
+
+        HRESULT result;
         if (isFilterLoaded()) {
-            m_lastTestResult = configurationTest(configuration, expectedResult);
+            result = test();
         } else {
             Logger::getInstance().error(L"Filter is not loaded! Test will not be executed.");
-            m_lastTestResult = E_FAIL;
+            result = E_FAIL;
         }
 
         if (isFilterLoaded()) { /// Need to check, because filter will be unloaded in case of TIMEOUT
             shutDownTest();
         }
 
-        m_testCv.notify_all();
+        if (audit) {    /// The filter was shut down, so it should have released all events it held
+            auditor.endScope();
+            auditor.record(getSuiteName(), m_runningTest, *audit);
+            m_aliveEvents = audit->getAlive();
+        }
+
+        return result;
     }
 
     bool GenericUnitTester::isFilterLoaded() {
         return m_testedFilter != nullptr;
     }
 
+    void GenericUnitTester::setExecutionMode(const NExecution_Mode mode) {
+        s_executionMode = mode;
+    }
+
+    void GenericUnitTester::setOutput(std::wostream& output, std::wostream& errorOutput) {
+        m_output = &output;
+        m_errorOutput = &errorOutput;
+    }
+
 
     //      **************************************************
     //                      Generic tests
@@ -275,20 +705,21 @@ namespace tester {
             Logger::getInstance().error(std::wstring(L"Actual result: ") + Describe_Error(afterShutDownEventResult));
             return E_FAIL;
         } else {
+            infoEvent->Release();   /// Rejected, so not consumed by the filter
             return S_OK;
         }
     }
 
     HRESULT GenericUnitTester::informativeEventsTest(const scgms::NDevice_Event_Code eventCode) {
         if (!isFilterLoaded()) {
-            std::wcerr << L"No filter created! Can't execute test.\n";
+            errorOutput() << L"No filter created! Can't execute test.\n";
             Logger::getInstance().error(L"No filter created! Can't execute test...");
             return E_FAIL;
         }
 
         scgms::IDevice_Event* event = createEvent(eventCode);
         if (event == nullptr) {
-            std::wcerr << L"Error while creating " << describeEvent(eventCode) << std::endl;
+            errorOutput() << L"Error while creating " << describeEvent(eventCode) << std::endl;
             Logger::getInstance().error(L"Error while creating " + describeEvent(eventCode));
             return E_FAIL;
         }
@@ -310,6 +741,7 @@ namespace tester {
             Logger::getInstance().error(L"Error while sending " + describeEvent(scgms::NDevice_Event_Code::Shut_Down));
             Logger::getInstance().error(std::wstring(L"expected result: ") + Describe_Error(S_OK));
             Logger::getInstance().error(std::wstring(L"actual result: ") + Describe_Error(result));
+            event->Release();
             result = E_FAIL;
         }
 
@@ -318,7 +750,7 @@ namespace tester {
 
     HRESULT GenericUnitTester::configureFilter(const tester::FilterConfig &config) {
         if (!isFilterLoaded()) {
-            std::wcerr << L"No filter loaded! Can't execute test.\n";
+            errorOutput() << L"No filter loaded! Can't execute test.\n";
             Logger::getInstance().error(L"No filter loaded! Can't execute test.");
             return E_FAIL;
         }
@@ -359,8 +791,16 @@ namespace tester {
 
 
 
-    CDynamic_Library &GenericUnitTester::getFilterLib() {
-        return m_filterLibrary;
+    std::wostream &GenericUnitTester::output() {
+        return *m_output;
+    }
+
+    std::wostream &GenericUnitTester::errorOutput() {
+        return *m_errorOutput;
+    }
+
+    TFilter_Library* GenericUnitTester::getFilterLib() {
+        return m_filterLibrary.get();
     }
 
     TestFilter &GenericUnitTester::getTestFilter() {
@@ -372,14 +812,13 @@ namespace tester {
     }
 
     void GenericUnitTester::loadFilterLibrary() {
-        const wchar_t* file_name = GuidFileMapper::GetInstance().getFileName(m_testedGuid);
-        std::wstring file = std::wstring(file_name) + cnst::LIB_EXTENSION;
-
-        m_filterLibrary.Load(file);
+        m_filterLibrary = FilterLibraryCache::getInstance().getFilterLibrary(m_testedGuid);
 
-        if (!m_filterLibrary.Is_Loaded()) {
-            std::wcerr << L"Couldn't load " << file_name << " library!\n";
-            Logger::getInstance().error(L"Couldn't load " + std::wstring(file_name) + L" library.");
+        if (!m_filterLibrary) {
+            const wchar_t* file_name = GuidFileMapper::GetInstance().getFileName(m_testedGuid);
+            std::wstring library = file_name ? file_name : GUID_To_WString(m_testedGuid);
+            errorOutput() << L"Couldn't load " << library << " library!\n";
+            Logger::getInstance().error(L"Couldn't load " + library + L" library.");
         }
     }
 }
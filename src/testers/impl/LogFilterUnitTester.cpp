@@ -1,4 +1,5 @@
 #include <iostream>
+#include <memory>
 #include <rtl/FilterLib.h>
 #include <rtl/hresult.h>
 #include "../LogFilterUnitTester.h"
@@ -14,6 +15,7 @@ namespace tester {
     const char* EVENT_ORDER_TEST_LOG = "eventOrderTestLog.csv";
     const char* POP_RESULT_REPEATING_TEST_LOG = "pushResultRepeatingTestLog.csv";
     const char* POP_EVENT_COUNT_TEST_LOG = "popEventCountTEstLog.csv";
+    const char* BENCHMARK_LOG = "tmp/benchmarkLog.csv";
 
     LogFilterUnitTester::LogFilterUnitTester() : GenericUnitTester(cnst::LOG_GUID){
         //
@@ -87,8 +89,8 @@ namespace tester {
             return E_FAIL;
         }
 
-        std::size_t eventCount = 3;
-        scgms::IDevice_Event* events[eventCount];
+        constexpr std::size_t eventCount = 3;
+        scgms::IDevice_Event* events[eventCount] = {};
         HRESULT creationResult = S_OK;
         for (std::size_t i = 0; i < eventCount; ++i) {
             events[i] = createEvent(scgms::NDevice_Event_Code::Level);
@@ -109,21 +111,18 @@ namespace tester {
             return E_FAIL;
         }
 
-        HRESULT testResult = S_OK;
-        for (scgms::IDevice_Event *event : events) {
-            HRESULT execResult = getTestedFilter()->Execute(event);
+        std::size_t executed = 0;
+        for (; executed < eventCount; ++executed) {
+            HRESULT execResult = getTestedFilter()->Execute(events[executed]);
             if (!Succeeded(execResult)) {
-                testResult = E_FAIL;
                 break;
             }
         }
 
-        if (!Succeeded(testResult)) {
+        if (executed < eventCount) {
             Logger::getInstance().error(L"Error while executing test events!");
-            for (auto event : events) {     /// If something went wrong, releasing all existing events
-                if (event) {
-                    event->Release();
-                }
+            for (std::size_t i = executed; i < eventCount; ++i) {     /// Releasing the events not consumed by the filter
+                events[i]->Release();
             }
 
             return E_FAIL;
@@ -180,13 +179,14 @@ namespace tester {
         }
 
         try {
-            std::vector<std::vector<std::string>> logLines = log::readLogFile(FILTER_OUTPUT_TEST_LOG);
+            LogReader logFile(FILTER_OUTPUT_TEST_LOG);
+            const TLog_Lines& logLines = logFile.getLines();
             if (logLines.size() < 2) {
                 Logger::getInstance().error(L"Log file does not contain a record of executed event!");
                 return E_FAIL;
             }
 
-            if (logLines[1][2] == "Level") {    /// Checking second line - first line is header, third field is event code
+            if (logLines[1].size() > 2 && logLines[1][2] == "Level") {    /// Checking second line - first line is header, third field is event code
                 Logger::getInstance().info(L"Level event record found!");
                 return S_OK;
             } else {
@@ -208,8 +208,8 @@ namespace tester {
             return E_FAIL;
         }
 
-        std::size_t eventCount = 3;
-        scgms::IDevice_Event* events[eventCount];
+        constexpr std::size_t eventCount = 3;
+        scgms::IDevice_Event* events[eventCount] = {};
         HRESULT creationResult = S_OK;
         for (std::size_t i = 0; i < eventCount; ++i) {
             scgms::NDevice_Event_Code eventCode;
@@ -240,37 +240,35 @@ namespace tester {
                 }
             }
 
-            E_FAIL;
+            return E_FAIL;
         }
 
-        HRESULT testResult = S_OK;
-        for (scgms::IDevice_Event *event : events) {
-            HRESULT execResult = getTestedFilter()->Execute(event);
+        std::size_t executed = 0;
+        for (; executed < eventCount; ++executed) {
+            HRESULT execResult = getTestedFilter()->Execute(events[executed]);
             if (!Succeeded(execResult)) {
-                testResult = E_FAIL;
                 break;
             }
         }
 
-        if (!Succeeded(testResult)) {       /// If something went wrong, releasing all existing events
+        if (executed < eventCount) {       /// If something went wrong, releasing the events not consumed by the filter
             Logger::getInstance().error(L"Error while executing test events!");
-            for (auto event : events) {
-                if (event) {
-                    event->Release();
-                }
+            for (std::size_t i = executed; i < eventCount; ++i) {
+                events[i]->Release();
             }
 
             return E_FAIL;
         }
 
-        std::vector<std::vector<std::string>> logLines;
+        std::unique_ptr<LogReader> logFile;
         try {
-            logLines = log::readLogFile(EVENT_ORDER_TEST_LOG);
+            logFile = std::make_unique<LogReader>(EVENT_ORDER_TEST_LOG);
         } catch (const std::runtime_error &error) {
             Logger::getInstance().error(L"Log file " + Widen_Char(EVENT_ORDER_TEST_LOG) + L" does not exist!");
             return E_FAIL;
         }
 
+        const TLog_Lines& logLines = logFile->getLines();
         if (logLines.size() < (eventCount + 1)) {   /// +1 for the header
             Logger::getInstance().error(L"Log file does not contain a record of some executed event!");
             return E_FAIL;
@@ -290,7 +288,7 @@ namespace tester {
                     break;
             }
 
-            if (logLines[i][2] != eventName) {  /// Checking second line - first line is header, third field is event code
+            if (logLines[i].size() <= 2 || logLines[i][2] != eventName) {  /// Checking second line - first line is header, third field is event code
                 Logger::getInstance().error(Widen_String(eventName) + L" event record not found!");
                 return E_FAIL;
             }
@@ -359,8 +357,8 @@ namespace tester {
             return E_FAIL;
         }
 
-        std::size_t eventCount = 3;
-        scgms::IDevice_Event* events[eventCount];
+        constexpr std::size_t eventCount = 3;
+        scgms::IDevice_Event* events[eventCount] = {};
         HRESULT creationResult = S_OK;
         for (std::size_t i = 0; i < eventCount; ++i) {
             events[i] = createEvent(scgms::NDevice_Event_Code::Level);
@@ -382,21 +380,18 @@ namespace tester {
             return E_FAIL;
         }
 
-        HRESULT testResult = S_OK;
-        for (scgms::IDevice_Event *event : events) {
-            HRESULT execResult = getTestedFilter()->Execute(event);
+        std::size_t executed = 0;
+        for (; executed < eventCount; ++executed) {
+            HRESULT execResult = getTestedFilter()->Execute(events[executed]);
             if (!Succeeded(execResult)) {
-                testResult = E_FAIL;
                 break;
             }
         }
 
-        if (!Succeeded(testResult)) {
+        if (executed < eventCount) {
             Logger::getInstance().error(L"Error while executing test events!");
-            for (auto event : events) {
-                if (event) {
-                    event->Release();
-                }
+            for (std::size_t i = executed; i < eventCount; ++i) {
+                events[i]->Release();
             }
 
 
@@ -430,4 +425,10 @@ namespace tester {
         Logger::getInstance().info(L"Expected number of events recognized by the log filter.");
         return S_OK;
     }
+
+    HRESULT LogFilterUnitTester::prepareBenchmark(GUID& signalId) {
+        filesystem::create_directory(cnst::TMP_DIR);
+        tester::LogFilterConfig config(BENCHMARK_LOG);
+        return configureFilter(config);
+    }
 }
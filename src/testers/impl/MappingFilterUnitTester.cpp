@@ -101,6 +101,7 @@ namespace tester {
 
         if (!Succeeded(execResult)) {
             Logger::getInstance().error(L"Error while executing " + describeEvent(eventCode));
+            event->Release();
             return E_FAIL;
         }
 
@@ -154,6 +155,7 @@ namespace tester {
 
         if (!Succeeded(execResult)) {
             Logger::getInstance().error(L"Error while executing " + describeEvent(eventCode));
+            event->Release();
             return E_FAIL;
         }
 
@@ -206,6 +208,7 @@ namespace tester {
 
         if (!Succeeded(execResult)) {
             Logger::getInstance().error(L"Error while executing " + describeEvent(eventCode));
+            event->Release();
             return E_FAIL;
         }
 
@@ -245,6 +248,7 @@ namespace tester {
 
         if (!Succeeded(execResult)) {
             Logger::getInstance().error(L"Error while executing " + describeEvent(eventCode));
+            event->Release();
             return E_FAIL;
         }
 
@@ -306,4 +310,9 @@ namespace tester {
 
         return testResult;
     }
-}
\ No newline at end of file
+
+    HRESULT MappingFilterUnitTester::prepareBenchmark(GUID& signalId) {
+        signalId = scgms::signal_BG;
+        return configureFilter(tester::MappingFilterConfig(scgms::signal_BG, scgms::signal_COB));
+    }
+}
@@ -86,6 +86,7 @@ namespace tester {
             HRESULT execResult = getTestedFilter()->Execute(event);
             if (!Succeeded(execResult)) {
                 Logger::getInstance().error(L"Error while executing " + describeEvent(scgms::NDevice_Event_Code::Level));
+                event->Release();
                 return E_FAIL;
             }
 
@@ -149,10 +150,16 @@ namespace tester {
                 Logger::getInstance().error(L"Error while executing event!");
                 Logger::getInstance().error(std::wstring(L"expected result: ") + Describe_Error(S_OK));
                 Logger::getInstance().error(std::wstring(L"actual result: ") + Describe_Error(execResult));
+                event->Release();
                 test_result = E_FAIL;
             }
         }
 
         return test_result;
     }
-}
\ No newline at end of file
+
+    HRESULT MaskingFilterUnitTester::prepareBenchmark(GUID& signalId) {
+        signalId = scgms::signal_BG;
+        return configureFilter(tester::MaskingFilterConfig(scgms::signal_BG, "1100110011001100"));
+    }
+}
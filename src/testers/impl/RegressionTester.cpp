@@ -10,11 +10,16 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include <memory>
+#include <thread>
+#include <future>
 #include <algorithm>
 #include <rtl/scgmsLib.h>
+#include <rtl/FilesystemLib.h>
 #include "../RegressionTester.h"
 #include "../../utils/constants.h"
 #include "../../utils/LogUtils.h"
+#include "../../utils/LogComparator.h"
 
 tester::RegressionTester::RegressionTester(std::wstring config_filepath) : config_filepath(std::move(config_filepath)),
                                                                    resultLog(Narrow_WChar(cnst::LOG_FILE)){
@@ -72,63 +77,55 @@ HRESULT tester::RegressionTester::compareLogs(const std::string& referenceLog) {
         return E_FAIL;
     }
 
-    std::vector<std::vector<std::string>> resultLogLinesVector = log::readLogFile(this->resultLog);
-    std::sort(resultLogLinesVector.begin() + 1, resultLogLinesVector.end(),
-        [](const std::vector<std::string>& first, const std::vector<std::string>& second) {
-        return std::stoi(first.at(0)) < std::stoi(second.at(0));
-        });
-
-    std::vector<std::vector<std::string>> referenceLogLinesVector = log::readLogFile(referenceLog);
-    std::sort(referenceLogLinesVector.begin() + 1, referenceLogLinesVector.end(),
-        [](const std::vector<std::string>& first, const std::vector<std::string>& second) {
-        return std::stoi(first.at(0)) < std::stoi(second.at(0));
-        });
-
-    std::vector<std::vector<std::string>> missingLines;
-    std::vector<std::string> mismatchLine;
-    std::vector<std::string> expectedLine;
-    bool logsAreEqual = true;
-    bool match = false;
-    bool firstMismatch = true;
-    int lastComparedLine = 1;
-    if (resultLogLinesVector[0].size() != referenceLogLinesVector[0].size()) {
-        // different number of parametes in line is not correct
-        std::wcerr << L"There is different number of parameters in first line!\n";
-        Logger::getInstance().error(L"There is different number of parameters in first line!");
+    /// Tolerances of the scenario are defined next to its reference log
+    ComparisonSchema schema;
+    try {
+        schema = ComparisonSchema::fromFile(filesystem::path(referenceLog).replace_filename(cnst::TOLERANCE_FILE).string());
+    } catch (const std::invalid_argument& ex) {
+        std::wcerr << L"Invalid tolerance of the scenario: " << ex.what() << L"\n";
+        Logger::getInstance().error(L"Invalid tolerance of the scenario: " + Widen_Char(ex.what()));
         return E_FAIL;
     }
 
-    for (size_t i = 1; i < referenceLogLinesVector.size(); i++) {
-        for (size_t j = lastComparedLine; j < resultLogLinesVector.size(); j++) {
-            if (log::compareLines(resultLogLinesVector.at(j), referenceLogLinesVector.at(i))) {
-                resultLogLinesVector.erase(resultLogLinesVector.begin() + j);
-                lastComparedLine = j;
-                match = true;
-                break;
-            }
-        }
-
-        if (!match) {
-            missingLines.push_back(referenceLogLinesVector.at(i));
-            if (firstMismatch) {
-                expectedLine = missingLines.at(0);
-                mismatchLine = resultLogLinesVector.at(lastComparedLine);
-                firstMismatch = false;
-            }
-            logsAreEqual = false;
+    /// Both logs share the dictionary, so their texts are compared by ids. The reference log is parsed
+    /// at the same time as the result log and each of them gets a half of the hardware threads.
+    LogDictionary dictionary;
+    const std::size_t threads = std::max(1u, std::thread::hardware_concurrency() / 2);
+    auto referenceLogParsing = std::async(std::launch::async, [&referenceLog, &dictionary, threads]() {
+        auto columns = std::make_unique<LogColumns>(referenceLog, dictionary, threads);
+        columns->sortByLogicalClock();
+        return columns;
+    });
+
+    LogColumns resultLogColumns(this->resultLog, dictionary, threads);
+    resultLogColumns.sortByLogicalClock();
+    const std::unique_ptr<LogColumns> referenceLogColumnsPtr = referenceLogParsing.get();
+    const LogColumns& referenceLogColumns = *referenceLogColumnsPtr;
+
+    if (resultLogColumns.isEmpty() || referenceLogColumns.isEmpty()) {
+        std::wcerr << L"Can't compare an empty log file!\n";
+        Logger::getInstance().error(L"Can't compare an empty log file!");
+        return E_FAIL;
+    }
 
-        }
-        match = false;
+    if (resultLogColumns.getHeader().size() != referenceLogColumns.getHeader().size()) {
+        // different number of parametes in line is not correct
+        std::wcerr << L"There is different number of parameters in first line!\n";
+        Logger::getInstance().error(L"There is different number of parameters in first line!");
+        return E_FAIL;
     }
 
-    if (logsAreEqual) {
+    const LogComparator comparator(schema, dictionary);
+    const TLog_Comparison comparison = comparator.compare(resultLogColumns.getColumns(), referenceLogColumns.getColumns());
+    if (comparison.missing.empty()) {
         std::wcout << "Test result is OK!\n";
         Logger::getInstance().info(L"Test result is OK!");
-        if (resultLogLinesVector.size() > 1) {
+        if (!comparison.redundant.empty()) {
             Logger::getInstance().info(L"There were reduntant lines found:");
             std::wcout << L"There were redundant lines found!\n";
-            resultLogLinesVector.erase(resultLogLinesVector.begin());
-            log::infoLogLines(resultLogLinesVector);
+            for (std::size_t row : comparison.redundant) {
+                log::infoLogLine(resultLogColumns.getRow(row));
+            }
         }
 
         return S_OK;
@@ -136,11 +133,17 @@ HRESULT tester::RegressionTester::compareLogs(const std::string& referenceLog) {
         Logger::getInstance().error(L"Test failed!");
         Logger::getInstance().error(L"First mismatch:");
         Logger::getInstance().error(L"Expected line:");
-        log::errorLogLine(expectedLine);
+        log::errorLogLine(referenceLogColumns.getRow(comparison.missing.front()));
         Logger::getInstance().error(L"Actual line:");
-        log::errorLogLine(mismatchLine);
+        if (comparison.firstMismatch != TLog_Comparison::npos) {
+            log::errorLogLine(resultLogColumns.getRow(comparison.firstMismatch));
+        } else {
+            Logger::getInstance().error(L"End of the log file.");
+        }
         Logger::getInstance().error(L"Lines that were not found:");
-        log::infoLogLines(missingLines);
+        for (std::size_t row : comparison.missing) {
+            log::infoLogLine(referenceLogColumns.getRow(row));
+        }
 
         std::wcout << L"There were lines missing in log file!\n";
         std::wcout << L"Test failed!\n";
@@ -0,0 +1,108 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "../ScanBenchmark.h"
+#include "../../utils/DelimiterScanner.h"
+#include "../../utils/Logger.h"
+
+namespace tester {
+
+    ScanBenchmark::ScanBenchmark(std::string logPath) : m_logPath(std::move(logPath)) {
+        //
+    }
+
+    void ScanBenchmark::scanByFind(const std::string& text, std::vector<std::uint32_t>& positions) {
+        positions.clear();
+        for (std::size_t line = 0; line < text.size(); ) {
+            std::size_t lineEnd = text.find(DelimiterScanner::LINE_BREAK, line);
+            if (lineEnd == std::string::npos) {
+                lineEnd = text.size();
+            }
+
+            for (std::size_t pos = text.find(DelimiterScanner::DELIMITER, line); pos < lineEnd;
+                 pos = text.find(DelimiterScanner::DELIMITER, pos + 1)) {
+                positions.push_back(static_cast<std::uint32_t>(pos));
+            }
+            if (lineEnd < text.size()) {
+                positions.push_back(static_cast<std::uint32_t>(lineEnd));
+            }
+            line = lineEnd + 1;
+        }
+    }
+
+    HRESULT ScanBenchmark::execute(const std::size_t runs) {
+        std::ifstream file(m_logPath, std::ios::binary);
+        if (!file) {
+            std::wcerr << L"Error while opening log file " << m_logPath.c_str() << L"!\n";
+            Logger::getInstance().error(L"Error while opening the benchmarked log file!");
+            return E_FAIL;
+        }
+        std::ostringstream content;
+        content << file.rdbuf();
+        const std::string text = content.str();
+        if (text.size() > UINT32_MAX) {
+            std::wcerr << L"The log file is too large to be scanned at once!\n";
+            Logger::getInstance().error(L"The benchmarked log file is too large!");
+            return E_FAIL;
+        }
+
+        std::vector<std::pair<std::wstring, std::function<void(std::vector<std::uint32_t>&)>>> methods;
+        methods.emplace_back(L"std::string::find", [&text](std::vector<std::uint32_t>& positions) {
+            scanByFind(text, positions);
+        });
+        for (NScan_Isa isa : { NScan_Isa::Scalar, NScan_Isa::SSE2, NScan_Isa::AVX2 }) {
+            if (DelimiterScanner::isSupported(isa)) {
+                methods.emplace_back(L"scanner " + DelimiterScanner::describe(isa), [&text, isa](std::vector<std::uint32_t>& positions) {
+                    DelimiterScanner::scan(text, positions, isa);
+                });
+            }
+        }
+
+        const double megabytes = text.size() / (1024.0 * 1024.0);
+        std::wcout << L"Scanning log " << m_logPath.c_str() << L" (" << std::fixed << std::setprecision(1) << megabytes
+                   << L" MiB, best of " << runs << L" runs):\n" << std::left << std::setw(24) << L"method" << std::right
+                   << std::setw(14) << L"positions" << std::setw(12) << L"ms" << std::setw(12) << L"MiB/s"
+                   << std::setw(10) << L"speedup" << L"\n";
+        Logger::getInstance().info(L"Benchmarking scanning of a log file...");
+
+        std::vector<std::uint32_t> expected, positions;
+        double baseline = 0.0;
+        HRESULT result = S_OK;
+        for (const auto& method : methods) {
+            double best = 0.0;
+            for (std::size_t i = 0; i < std::max<std::size_t>(runs, 1); i++) {
+                const auto start = std::chrono::steady_clock::now();
+                method.second(positions);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                best = i == 0 ? seconds : std::min(best, seconds);
+            }
+
+            if (baseline == 0.0) {      /// The first method is the reference one
+                baseline = best;
+                expected = positions;
+            } else if (positions != expected) {
+                std::wcerr << method.first << L" found different positions than " << methods.front().first << L"!\n";
+                Logger::getInstance().error(method.first + L" found different positions than " + methods.front().first);
+                result = E_FAIL;
+            }
+
+            std::wcout << std::left << std::setw(24) << method.first << std::right << std::setw(14) << positions.size()
+                       << std::setprecision(2) << std::setw(12) << best * 1000.0 << std::setprecision(0) << std::setw(12)
+                       << (best > 0.0 ? megabytes / best : 0.0) << std::setprecision(2) << std::setw(9)
+                       << (best > 0.0 ? baseline / best : 0.0) << L"x\n";
+            Logger::getInstance().info(method.first + L": " + std::to_wstring(best * 1000.0) + L" ms");
+        }
+
+        std::wcout << std::defaultfloat << std::setprecision(6);
+        return result;
+    }
+}
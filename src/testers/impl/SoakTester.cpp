@@ -0,0 +1,193 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <chrono>
+#include <thread>
+#include <iomanip>
+#include <algorithm>
+#include "../SoakTester.h"
+#include "../../utils/Logger.h"
+#include "../../utils/LatencyHistogram.h"
+
+namespace tester {
+
+    /// Share of the steps between samples which have to be strictly increasing for a series to be considered growing
+    constexpr double GROWING_STEPS = 0.75;
+    /// Growth of the RSS which is tolerated, in kilobytes and relatively to the first checked sample
+    constexpr double TOLERATED_RSS_GROWTH = 1024.0;
+    constexpr double TOLERATED_RSS_RATIO = 0.02;
+    /// Growth of the open file descriptors which is tolerated, e.g. files opened lazily after the warm-up
+    constexpr double TOLERATED_FILES_GROWTH = 2.0;
+    /// Ratio of the mean p99 latency of the last and the first third of the samples considered a drift
+    constexpr double LATENCY_DRIFT_RATIO = 1.5;
+    /// Period in which the executed events are caught up with the requested rate
+    constexpr std::chrono::milliseconds TICK{10};
+
+    /**
+     * Checks whether given series grows - most of its steps increase and it grew more than tolerated overall.
+     * Flat steps don't count, so a single step up, e.g. a lazily allocated buffer, isn't reported as growth.
+     * @param series sampled values
+     * @param toleratedGrowth difference of the last and the first value which is still tolerated
+     */
+    static bool isGrowing(const std::vector<double>& series, const double toleratedGrowth) {
+        if (series.size() < 2) {
+            return false;
+        }
+
+        std::size_t increasing = 0;
+        for (std::size_t i = 1; i < series.size(); i++) {
+            if (series[i] > series[i - 1]) {
+                increasing++;
+            }
+        }
+
+        return increasing >= GROWING_STEPS * (series.size() - 1) && series.back() - series.front() > toleratedGrowth;
+    }
+
+    /// Returns mean of given part of the series
+    static double meanOf(std::vector<double>::const_iterator begin, std::vector<double>::const_iterator end) {
+        double sum = 0.0;
+        for (auto it = begin; it != end; ++it) {
+            sum += *it;
+        }
+        return begin == end ? 0.0 : sum / static_cast<double>(end - begin);
+    }
+
+    SoakTester::SoakTester(const TSoak_Options& options, const TGenerator_Config& generatorConfig)
+            : m_options(options), m_generatorConfig(generatorConfig) {
+        //
+    }
+
+    HRESULT SoakTester::execute(scgms::IFilter* target, const std::wstring& name, std::wostream& output) const {
+        output << "****************************************\n"
+               << "Soak testing " << name << " (" << m_options.rate << " events/s for " << m_options.duration
+               << " s, sampled every " << m_options.interval << " s):\n"
+               << "****************************************\n"
+               << std::setw(10) << "elapsed s" << std::setw(12) << "events/s" << std::setw(10) << "rejected"
+               << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(12) << "max ns"
+               << std::setw(12) << "RSS kB" << std::setw(8) << "fds" << "\n";
+        Logger::getInstance().info(L"Soak testing " + name + L"...");
+
+        using clock = std::chrono::steady_clock;
+        const auto duration = std::chrono::duration<double>(m_options.duration);
+        const auto interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(m_options.interval));
+
+        EventGenerator generator(m_generatorConfig);
+        std::vector<TSoak_Sample> samples;
+        LatencyHistogram latencies;
+        std::uint64_t executed = 0;
+        std::uint64_t rejected = 0;
+
+        const auto start = clock::now();
+        auto intervalStart = start;
+        auto nextSample = start + interval;
+        for (auto now = start; now - start < duration; now = clock::now()) {
+            /// Catching up with the requested rate, if the target is slower, it's executing events all the time
+            const auto due = static_cast<std::uint64_t>(std::chrono::duration<double>(now - start).count() * m_options.rate);
+            for (; executed < due; executed++) {
+                scgms::IDevice_Event* event = generator.next();
+                if (event == nullptr) {
+                    Logger::getInstance().error(L"Error while generating events!");
+                    return E_FAIL;
+                }
+
+                const auto executeStart = clock::now();
+                const HRESULT executeResult = target->Execute(event);
+                latencies.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - executeStart).count()));
+                if (!Succeeded(executeResult)) {
+                    event->Release();   /// Not consumed by the target
+                    rejected++;
+                }
+
+                if ((executed & 0xFF) == 0 && clock::now() >= nextSample) {  /// Target is behind, still sampling on time
+                    executed++;
+                    break;
+                }
+            }
+
+            now = clock::now();
+            if (now >= nextSample) {
+                TSoak_Sample sample;
+                sample.elapsed = std::chrono::duration<double>(now - start).count();
+                sample.events = latencies.getCount();
+                sample.rejected = rejected;
+                sample.rate = sample.events / std::chrono::duration<double>(now - intervalStart).count();
+                sample.p50 = latencies.getPercentile(50.0);
+                sample.p99 = latencies.getPercentile(99.0);
+                sample.max = latencies.getMax();
+                sample.usage = sampleProcessUsage();
+                printSample(output, sample);
+                samples.push_back(sample);
+
+                latencies.reset();
+                rejected = 0;
+                intervalStart = now;
+                nextSample += interval;
+            }
+
+            std::this_thread::sleep_until(std::min(now + TICK, nextSample));
+        }
+
+        return checkDrift(output, samples) ? S_OK : E_FAIL;
+    }
+
+    void SoakTester::printSample(std::wostream& output, const TSoak_Sample& sample) {
+        output << std::fixed << std::setprecision(0) << std::setw(10) << sample.elapsed << std::setw(12) << sample.rate
+               << std::defaultfloat << std::setprecision(6) << std::setw(10) << sample.rejected
+               << std::setw(10) << sample.p50 << std::setw(10) << sample.p99 << std::setw(12) << sample.max
+               << std::setw(12) << sample.usage.rss << std::setw(8) << sample.usage.openFiles << "\n";
+        Logger::getInstance().info(L"Soak sample at " + std::to_wstring(sample.elapsed) + L" s: "
+                                   + std::to_wstring(sample.rate) + L" events/s, " + std::to_wstring(sample.rejected)
+                                   + L" rejected, p50 " + std::to_wstring(sample.p50) + L" ns, p99 "
+                                   + std::to_wstring(sample.p99) + L" ns, max " + std::to_wstring(sample.max)
+                                   + L" ns, RSS " + std::to_wstring(sample.usage.rss) + L" kB, "
+                                   + std::to_wstring(sample.usage.openFiles) + L" open files");
+    }
+
+    bool SoakTester::checkDrift(std::wostream& output, const std::vector<TSoak_Sample>& samples) {
+        constexpr std::size_t MIN_CHECKED_SAMPLES = 3;
+        if (samples.size() < MIN_CHECKED_SAMPLES + 1) {     /// The first sample is a warm-up
+            output << "Not enough samples to detect drift, at least " << (MIN_CHECKED_SAMPLES + 1)
+                   << " intervals are needed.\n";
+            Logger::getInstance().warn(L"Not enough samples to detect drift!");
+            return true;
+        }
+
+        std::vector<double> rss, openFiles, p99;
+        for (auto sample = samples.begin() + 1; sample != samples.end(); ++sample) {
+            rss.push_back(static_cast<double>(sample->usage.rss));
+            openFiles.push_back(static_cast<double>(sample->usage.openFiles));
+            p99.push_back(static_cast<double>(sample->p99));
+        }
+
+        bool stable = true;
+        if (rss.front() >= 0 && isGrowing(rss, std::max(TOLERATED_RSS_GROWTH, TOLERATED_RSS_RATIO * rss.front()))) {
+            output << "RSS keeps growing: " << rss.front() << " kB -> " << rss.back() << " kB!\n";
+            Logger::getInstance().error(L"RSS keeps growing during the soak test!");
+            stable = false;
+        }
+
+        if (openFiles.front() >= 0 && isGrowing(openFiles, TOLERATED_FILES_GROWTH)) {
+            output << "Open file descriptors keep growing: " << openFiles.front() << " -> " << openFiles.back() << "!\n";
+            Logger::getInstance().error(L"Open file descriptors keep growing during the soak test!");
+            stable = false;
+        }
+
+        const std::size_t third = std::max<std::size_t>(1, p99.size() / 3);
+        const double firstLatency = meanOf(p99.begin(), p99.begin() + third);
+        const double lastLatency = meanOf(p99.end() - third, p99.end());
+        if (firstLatency > 0.0 && lastLatency > LATENCY_DRIFT_RATIO * firstLatency) {
+            output << "Latency drifts: mean p99 " << std::fixed << std::setprecision(0) << firstLatency << " ns -> "
+                   << lastLatency << " ns!\n" << std::defaultfloat << std::setprecision(6);
+            Logger::getInstance().error(L"Latency drifts during the soak test!");
+            stable = false;
+        }
+
+        if (stable) {
+            output << "No growth of memory or open files and no latency drift detected.\n";
+            Logger::getInstance().info(L"No growth or drift detected during the soak test.");
+        }
+        return stable;
+    }
+}
@@ -0,0 +1,41 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_ALLOCATIONCOUNTER_H
+#define SMARTTESTER_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+namespace tester {
+
+    /// Heap allocations counted between start and stop of the counting
+    struct TAllocation_Count {
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    /**
+     * Returns true if heap allocations can be counted by this build. The tester interposes malloc, calloc, realloc
+     * and the aligned allocation functions of the C library, which is possible with glibc only and is done only
+     * when built with the SMARTTESTER_ALLOCATION_COUNTING CMake option, so other builds keep the stock allocator.
+     * Because the executable's definitions take precedence during symbol resolution, allocations of already built
+     * filter libraries are counted as well, including operator new, which allocates through malloc
+     * (or aligned_alloc for over-aligned types).
+     */
+    bool isAllocationCountingSupported();
+
+    /**
+     * Resets the counters and starts counting heap allocations of the whole process, including threads
+     * started by the tested filter.
+     */
+    void startAllocationCounting();
+
+    /**
+     * Stops counting heap allocations.
+     * @return allocations counted since the last start
+     */
+    TAllocation_Count stopAllocationCounting();
+}
+
+#endif //SMARTTESTER_ALLOCATIONCOUNTER_H
@@ -0,0 +1,44 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_CHILDPROCESS_H
+#define SMARTTESTER_CHILDPROCESS_H
+
+#include <string>
+#include <functional>
+#include <rtl/hresult.h>
+#include "ResourceMeter.h"
+
+namespace tester {
+
+    /// Way the test executed in a child process ended
+    enum class NChild_State {
+        Finished,
+        Timed_Out,
+        Crashed
+    };
+
+    /**
+     * Returns true if tests can be executed in child processes on this platform.
+     */
+    bool isChildProcessSupported();
+
+    /**
+     * Executes given test in a forked child process. The child sends the result back to the parent over a pipe.
+     * If the result doesn't arrive before the timeout expires, the child is killed, so a hung test can't block
+     * the tester. If the child process is not supported, the test is executed in the calling thread.
+     * No other thread may be executing tests meanwhile, the child would inherit the locks they hold.
+     *
+     * @param test test to execute
+     * @param timeout maximum execution time in milliseconds
+     * @param result result of the test, valid only if the test finished
+     * @param metrics resources consumed by the child, only wall time is known if the test didn't finish
+     * @param description description of the child's termination if it crashed
+     * @return the way the test ended
+     */
+    NChild_State runInChildProcess(const std::function<HRESULT(void)>& test, long timeout, HRESULT& result,
+                                   TTest_Metrics& metrics, std::wstring& description);
+}
+
+#endif //SMARTTESTER_CHILDPROCESS_H
@@ -0,0 +1,79 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_COMPARISONSCHEMA_H
+#define SMARTTESTER_COMPARISONSCHEMA_H
+
+#include <map>
+#include <string>
+#include <cstdint>
+#include "LogColumns.h"
+
+namespace tester {
+
+    /// Ways the tolerance of numeric values is measured
+    enum class NTolerance_Kind : std::uint8_t {
+        /// Difference of the values
+        Absolute,
+        /// Difference of the values relative to the larger of their magnitudes
+        Relative,
+        /// Number of doubles representable between the values
+        Ulp
+    };
+
+    /// Allowed difference of numeric values of matched rows
+    struct TTolerance {
+        NTolerance_Kind kind = NTolerance_Kind::Absolute;
+        double value = 0.0;
+
+        /// Returns true if given values don't differ by more than the tolerance
+        bool accepts(double expected, double actual) const;
+    };
+
+    /**
+     * Tolerances the numeric columns of a result log are compared with, per column and optionally per signal.
+     * Scenarios may define their schema in cnst::TOLERANCE_FILE next to their configuration, one tolerance per line:
+     *
+     *      <column>; absolute|relative|ulp; <tolerance>[; <signal>]
+     *
+     * where the column is named as in the log header (Info, Segment Id, Event Code Id) and the signal as in the Signal
+     * column of the log. Tolerances without a signal apply to the whole column, the others override them for the rows
+     * of the signal. Empty lines and lines starting with '#' are ignored.
+     * Columns without a tolerance are compared with the absolute DEFAULT_TOLERANCE.
+     */
+    class ComparisonSchema {
+    public:
+        /// Number of the numeric columns, starting at NLog_Column::Info
+        static constexpr std::size_t NUMERIC_COLUMNS = NLog_Column::Device_Id - NLog_Column::Info;
+        /// Absolute tolerance of columns which don't define their own
+        static constexpr double DEFAULT_TOLERANCE = 0.0001;
+    private:
+        TTolerance m_columns[NUMERIC_COLUMNS];
+        /// Tolerances overridden for the rows of a signal, mapped to the name of the signal
+        std::map<std::string, TTolerance> m_signals[NUMERIC_COLUMNS];
+    public:
+        /// Creates the default schema, all columns compared with the absolute DEFAULT_TOLERANCE
+        ComparisonSchema();
+        /**
+         * Loads schema from given file, columns not mentioned in the file keep the default tolerance.
+         * @param path path to the schema file, the default schema is returned if it doesn't exist
+         * @throws std::invalid_argument if a line of the file isn't a valid tolerance
+         */
+        static ComparisonSchema fromFile(const std::string& path);
+
+        /**
+         * Sets tolerance of given column.
+         * @param column numeric column of the log
+         * @param tolerance tolerance of the column
+         * @param signal name of the signal the tolerance is limited to, empty for the whole column
+         */
+        void setTolerance(NLog_Column column, const TTolerance& tolerance, const std::string& signal = std::string());
+        /// Returns tolerance of given numeric column, 0 being the Info column
+        const TTolerance& getTolerance(std::size_t slot) const;
+        /// Returns tolerances overridden for rows of some signals, mapped to the names of the signals
+        const std::map<std::string, TTolerance>& getSignalTolerances(std::size_t slot) const;
+    };
+}
+
+#endif //SMARTTESTER_COMPARISONSCHEMA_H
@@ -0,0 +1,39 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_COUNTINGFILTER_H
+#define SMARTTESTER_COUNTINGFILTER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iface/FilterIface.h>
+#include <rtl/referencedImpl.h>
+
+/**
+ * Filter terminating a benchmarked filter chain. It only counts received events by their code and releases them,
+ * so the measured throughput is not affected by storing or writing the events anywhere.
+ */
+class CountingFilter : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced {
+
+    using IFilter_Configuration = refcnt::IVector_Container<scgms::IFilter_Parameter*>;
+private:
+    static constexpr std::size_t CODE_COUNT = static_cast<std::size_t>(scgms::NDevice_Event_Code::count);
+
+    /// Received events, indexed by event code
+    std::array<std::atomic<std::uint64_t>, CODE_COUNT> m_counts;
+public:
+    CountingFilter();
+    ~CountingFilter() override = default;
+
+    /// Returns number of received events with given code.
+    std::uint64_t getCount(scgms::NDevice_Event_Code eventCode) const;
+    /// Returns number of all received events.
+    std::uint64_t getTotal() const;
+
+    HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) final;
+    HRESULT IfaceCalling Configure(IFilter_Configuration* configuration, refcnt::wstr_list *error_description) final;
+};
+
+#endif //SMARTTESTER_COUNTINGFILTER_H
@@ -0,0 +1,50 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_DELIMITERSCANNER_H
+#define SMARTTESTER_DELIMITERSCANNER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace tester {
+
+    /// Instruction sets the scanner can be executed with
+    enum class NScan_Isa {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    /**
+     * Finds separators and line breaks of a log in one pass. The text is compared 16 (SSE2) or 32 (AVX2) bytes
+     * at a time and the positions are extracted from the bit masks of the matches, so the long GUID and signal
+     * name tokens cost a few instructions each instead of a comparison per character.
+     * AVX2 is chosen at runtime, so the tester doesn't have to be compiled for it.
+     */
+    class DelimiterScanner {
+    public:
+        /// Separator of the tokens of a log line
+        static constexpr char DELIMITER = ';';
+        static constexpr char LINE_BREAK = '\n';
+
+        /// Returns the best instruction set available on this CPU
+        static NScan_Isa getBestIsa();
+        /// Returns true if given instruction set can be used on this CPU
+        static bool isSupported(NScan_Isa isa);
+        /// Returns name of given instruction set
+        static std::wstring describe(NScan_Isa isa);
+        /**
+         * Finds all separators and line breaks in given text.
+         * @param text scanned text, at most 4 GiB long
+         * @param positions receives ascending positions of the separators and line breaks, previous content is replaced
+         * @param isa instruction set to use, must be supported
+         */
+        static void scan(std::string_view text, std::vector<std::uint32_t>& positions, NScan_Isa isa = getBestIsa());
+    };
+}
+
+#endif //SMARTTESTER_DELIMITERSCANNER_H
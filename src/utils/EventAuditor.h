@@ -0,0 +1,93 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_EVENTAUDITOR_H
+#define SMARTTESTER_EVENTAUDITOR_H
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include <iface/DeviceIface.h>
+
+namespace tester {
+
+    /// Counters of events created within one audited scope
+    struct TEvent_Audit {
+        /// Events created by the tester and clones made of them
+        std::atomic<std::uint64_t> created{0};
+        /// Events whose last reference was released
+        std::atomic<std::uint64_t> released{0};
+
+        /// Returns number of events which are still alive
+        std::uint64_t getAlive() const;
+    };
+
+    /// Audited events of one filter, summed over all its tests
+    struct TFilter_Audit {
+        std::uint64_t created = 0;
+        std::uint64_t released = 0;
+        /// Tests which ended with some events still alive, with the number of those events
+        std::vector<std::pair<std::wstring, std::uint64_t>> leakingTests;
+    };
+
+    /**
+     * Singleton auditing lifetime of device events. When enabled, every event created by the tester is wrapped
+     * into a proxy counting its references, so every created event (and every clone of it) can be matched
+     * with its final Release. Events are counted into the scope opened by the thread which created them,
+     * which is done for every executed test. Events created by the filters themselves through scgms
+     * can't be seen by the auditor.
+     */
+    class EventAuditor {
+    private:
+        /// Guards the per-filter results, testers may run in parallel
+        std::mutex m_mutex;
+        std::atomic<bool> m_enabled;
+        /// Audited events, mapped to the name of the tested filter
+        std::map<std::wstring, TFilter_Audit> m_filters;
+
+        EventAuditor();
+    public:
+        static EventAuditor& getInstance();
+        void enable();
+        bool isEnabled() const;
+        /**
+         * Opens a new audited scope for the calling thread, replacing the previous one.
+         * @return counters of the scope, which stay valid for events outliving it
+         */
+        std::shared_ptr<TEvent_Audit> beginScope();
+        /// Closes the audited scope of the calling thread, events created afterwards aren't audited
+        void endScope();
+        /**
+         * Wraps given event created by the tester into an audited proxy, if the auditor is enabled and the calling
+         * thread has an open scope. Otherwise returns the event itself.
+         * @param event newly created event
+         * @return event which should be used instead of given one
+         */
+        scgms::IDevice_Event* track(scgms::IDevice_Event* event);
+        /**
+         * Records outcome of a closed scope into the results of given filter and logs the events still alive.
+         * @param filter name of the tested filter
+         * @param test name of the test
+         * @param audit counters of the closed scope
+         */
+        void record(const std::wstring& filter, const std::wstring& test, const TEvent_Audit& audit);
+        /**
+         * Prints created, released and alive events of every audited filter, followed by the tests which
+         * ended with events still alive.
+         * @param output stream the summary is printed into
+         * @return true if no event stayed alive
+         */
+        bool printSummary(std::wostream& output);
+
+        EventAuditor(EventAuditor const&) = delete;
+        void operator=(EventAuditor const&) = delete;
+    };
+}
+
+#endif //SMARTTESTER_EVENTAUDITOR_H
@@ -0,0 +1,127 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_EVENTGENERATOR_H
+#define SMARTTESTER_EVENTGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <rtl/guid.h>
+#include <rtl/hresult.h>
+#include <iface/DeviceIface.h>
+#include <iface/FilterIface.h>
+
+/// Configuration of the synthetic event stream
+struct TGenerator_Config {
+    /// Generated event codes with their relative weights
+    std::vector<std::pair<scgms::NDevice_Event_Code, double>> eventCodes = {
+            { scgms::NDevice_Event_Code::Level, 85.0 },
+            { scgms::NDevice_Event_Code::Masked_Level, 5.0 },
+            { scgms::NDevice_Event_Code::Parameters, 5.0 },
+            { scgms::NDevice_Event_Code::Information, 5.0 }
+    };
+    /// Signal ids of generated events with their relative weights
+    std::vector<std::pair<GUID, double>> signals = {
+            { scgms::signal_IG, 70.0 },
+            { scgms::signal_BG, 20.0 },
+            { scgms::signal_COB, 10.0 }
+    };
+    /// Device time of the first event, in days (rat time)
+    double startTime = 43831.0;
+    /// Device time between two consecutive events, in days - five minutes by default
+    double timeStep = 5.0 / (24.0 * 60.0);
+    /// Number of events in one time segment, 0 means no segment boundaries are generated
+    std::size_t segmentLength = 0;
+    /// Number of values carried by parameters events
+    std::size_t parameterCount = 8;
+    /// Seed of the pseudo-random generator, the same seed always produces the same stream
+    std::uint64_t seed = 42;
+};
+
+/**
+ * Produces a deterministic stream of synthetic device events for load tests. Event codes and signal ids
+ * are drawn from the configured weighted distributions, device time advances by a fixed step
+ * and every segmentLength events the current time segment is stopped and a new one is started.
+ * Levels follow a bounded mean-reverting random walk, so the filters see a plausible glucose-like signal.
+ * The generator isn't thread-safe, streams for multiple threads should be generated in advance.
+ */
+class EventGenerator {
+private:
+    TGenerator_Config m_config;
+    /// State of the splitmix64 pseudo-random generator
+    std::uint64_t m_randomState;
+    /// Cumulative weights of the configured event codes and signals
+    std::vector<double> m_codeWeights;
+    std::vector<double> m_signalWeights;
+
+    double m_deviceTime;
+    /// Last generated level
+    double m_level = 7.0;
+    /// Id of the current segment, 0 before the first one was started
+    std::uint64_t m_segmentId = 0;
+    /// Events generated in the current segment
+    std::size_t m_segmentEvents = 0;
+    /// Whether the current segment was already started
+    bool m_segmentOpen = false;
+
+    /**
+     * Creates the next event of the stream with given code and fills in the generated attributes.
+     * @param eventCode code of the created event
+     * @return created event, nullptr if it couldn't be created
+     */
+    scgms::IDevice_Event* createNext(scgms::NDevice_Event_Code eventCode);
+    /// Returns next pseudo-random number uniformly distributed in [0, 1)
+    double nextUniform();
+    /**
+     * Draws an index of a weighted item.
+     * @param cumulativeWeights cumulative weights of the items, mustn't be empty
+     * @return index of the drawn item
+     */
+    std::size_t nextIndex(const std::vector<double>& cumulativeWeights);
+public:
+    explicit EventGenerator(TGenerator_Config config = TGenerator_Config{});
+
+    /**
+     * Returns next event of the stream, which may be a segment start or stop. Returned pointer is non-owning
+     * and the event is deleted during its execution, otherwise it has to be released.
+     * @return next event, nullptr if it couldn't be created
+     */
+    scgms::IDevice_Event* next();
+    /**
+     * Generates given number of next events of the stream.
+     * @param count number of generated events
+     * @return generated events, empty if any of them couldn't be created
+     */
+    std::vector<scgms::IDevice_Event*> generate(std::size_t count);
+    /**
+     * Executes given number of next events of the stream upon given filter or filter chain.
+     * @param filter filter executing the events
+     * @param count number of executed events
+     * @param rejected receives number of events the filter failed to execute
+     * @return S_OK if all events were created, E_FAIL otherwise
+     */
+    HRESULT drive(scgms::IFilter* filter, std::size_t count, std::size_t& rejected);
+    /// Returns id of the current time segment
+    std::uint64_t getSegmentId() const;
+
+    /**
+     * Parses weighted signals in format "<signal>:<weight>,..." e.g. "IG:7,BG:2,COB:1". A signal is either
+     * its name (BG, IG, ISIG, COB, IOB, Calibration, Carb_Intake) or a GUID.
+     * @param specification weighted signals
+     * @return parsed signals with their weights
+     * @throws std::invalid_argument if the specification is invalid
+     */
+    static std::vector<std::pair<GUID, double>> parseSignals(const std::string& specification);
+    /**
+     * Parses weighted event codes in format "<code>:<weight>,..." e.g. "level:85,masked:5,parameters:5,information:5".
+     * @param specification weighted event codes
+     * @return parsed event codes with their weights
+     * @throws std::invalid_argument if the specification is invalid
+     */
+    static std::vector<std::pair<scgms::NDevice_Event_Code, double>> parseEventCodes(const std::string& specification);
+};
+
+#endif //SMARTTESTER_EVENTGENERATOR_H
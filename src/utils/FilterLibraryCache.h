@@ -0,0 +1,58 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_FILTERLIBRARYCACHE_H
+#define SMARTTESTER_FILTERLIBRARYCACHE_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <rtl/Dynamic_Library.h>
+#include <iface/FilterIface.h>
+
+/**
+ * Filter library loaded once for the whole process, together with its already resolved entry points.
+ */
+struct TFilter_Library {
+    CDynamic_Library library;
+    scgms::TCreate_Filter createFilter = nullptr;
+    scgms::TGet_Filter_Descriptors getFilterDescriptors = nullptr;
+};
+
+/**
+ * Singleton cache of loaded filter libraries. Every library is loaded and its entry points are resolved only once,
+ * testers share the handles through reference-counted pointers. Libraries stay loaded until the cache is destroyed
+ * at the process exit, so testers of filters from the same library don't load it again one after another.
+ */
+class FilterLibraryCache {
+private:
+    /// Guards the map, testers of different filters may run in parallel
+    std::mutex m_mutex;
+    /// Loaded libraries mapped to the file name they were loaded from
+    std::map<std::wstring, std::shared_ptr<TFilter_Library>> m_libraries;
+
+    FilterLibraryCache() = default;
+public:
+    static FilterLibraryCache& getInstance();
+    /**
+     * Returns the library with given file name, loads it and resolves its entry points if it's not loaded yet.
+     *
+     * @param fileName name of the library file, including the extension
+     * @return shared library handle, nullptr if the library couldn't be loaded
+     */
+    std::shared_ptr<TFilter_Library> getLibrary(const std::wstring& fileName);
+    /**
+     * Returns the library containing filter with given GUID, according to GuidFileMapper.
+     *
+     * @param filterGuid GUID of the filter
+     * @return shared library handle, nullptr if the library couldn't be loaded or the filter is not mapped
+     */
+    std::shared_ptr<TFilter_Library> getFilterLibrary(const GUID& filterGuid);
+
+    FilterLibraryCache(FilterLibraryCache const&) = delete;
+    void operator=(FilterLibraryCache const&) = delete;
+};
+
+#endif //SMARTTESTER_FILTERLIBRARYCACHE_H
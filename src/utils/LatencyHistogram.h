@@ -0,0 +1,58 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_LATENCYHISTOGRAM_H
+#define SMARTTESTER_LATENCYHISTOGRAM_H
+
+#include <array>
+#include <cstdint>
+
+namespace tester {
+
+    /**
+     * High-dynamic-range histogram of latencies in nanoseconds. Values are counted in log-linear buckets - every power
+     * of two range is split into 64 buckets of equal width - so any value from nanoseconds to hours is recorded
+     * in constant time and memory with relative error below 1/64, while rare long stalls stay visible in high
+     * percentiles and maximum.
+     */
+    class LatencyHistogram {
+    private:
+        /// Bits of precision kept from every value, values below 2^(SUB_BUCKET_BITS + 1) are counted exactly
+        static constexpr unsigned int SUB_BUCKET_BITS = 6;
+        static constexpr std::size_t SUB_BUCKET_COUNT = std::size_t(1) << SUB_BUCKET_BITS;
+        static constexpr std::size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS) * SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+
+        std::array<std::uint64_t, BUCKET_COUNT> m_counts{};
+        std::uint64_t m_count;
+        std::uint64_t m_total;
+        std::uint64_t m_min;
+        std::uint64_t m_max;
+
+        static std::size_t bucketIndex(std::uint64_t value);
+        /// Returns the highest value counted in the bucket with given index
+        static std::uint64_t bucketHighestValue(std::size_t index);
+    public:
+        LatencyHistogram();
+        /// Records given latency in nanoseconds
+        void record(std::uint64_t value);
+        /// Adds all values recorded in other histogram into this one
+        void merge(const LatencyHistogram& other);
+        /// Forgets all recorded values
+        void reset();
+        std::uint64_t getCount() const;
+        /// Returns sum of all recorded values
+        std::uint64_t getTotal() const;
+        double getMean() const;
+        std::uint64_t getMin() const;
+        std::uint64_t getMax() const;
+        /**
+         * Returns the value, which is greater or equal than given percentage of recorded values.
+         * @param percentile percentile between 0 and 100
+         * @return value at the percentile with the precision of the histogram, 0 if nothing was recorded
+         */
+        std::uint64_t getPercentile(double percentile) const;
+    };
+}
+
+#endif //SMARTTESTER_LATENCYHISTOGRAM_H
@@ -0,0 +1,151 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_LOGCOLUMNS_H
+#define SMARTTESTER_LOGCOLUMNS_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include "LogReader.h"
+
+namespace tester {
+
+    /// Positions of the columns in a line of a log
+    enum NLog_Column : std::size_t {
+        Logical_Clock = 0,
+        Device_Time,
+        Event_Code,
+        Signal,
+        Info,
+        Segment_Id,
+        Event_Code_Id,
+        Device_Id,
+        /// Columns following the known ones, not present in logs of current SmartCGMS
+        Rest
+    };
+
+    /// Kind of a value in a numeric column
+    enum class NLog_Value : std::uint8_t {
+        Empty,
+        Number,
+        /// Value which isn't a number, e.g. the text of an information event
+        Text
+    };
+
+    /**
+     * Interned texts of log columns. Logs which are compared share one dictionary, so their equal texts
+     * have equal ids and are compared as integers. Texts are views into the logs, so the dictionary
+     * can't be used once the logs are destroyed.
+     */
+    class LogDictionary {
+    private:
+        std::unordered_map<std::string_view, std::uint32_t> m_ids;
+        std::vector<std::string_view> m_texts;
+        /// Guards merging of dictionaries of logs parsed at the same time
+        std::mutex m_mergeMutex;
+    public:
+        /// Id of the empty text
+        static constexpr std::uint32_t EMPTY = 0;
+        /// Id of texts which aren't in the dictionary
+        static constexpr std::uint32_t NOT_FOUND = UINT32_MAX;
+
+        LogDictionary();
+        /// Returns id of given text, new texts are added
+        std::uint32_t intern(std::string_view text);
+        /// Returns text with given id
+        std::string_view getText(std::uint32_t id) const;
+        /// Returns id of given text without adding it, NOT_FOUND if the text isn't in the dictionary
+        std::uint32_t find(std::string_view text) const;
+        /// Returns number of texts, ids are lower than the size
+        std::size_t size() const;
+        /**
+         * Adds all texts of given dictionary, may be called from more threads at once.
+         * @param other dictionary of a part of a log parsed separately
+         * @return ids in this dictionary indexed by the ids in the other one
+         */
+        std::vector<std::uint32_t> merge(const LogDictionary& other);
+    };
+
+    /// Column compared as a number, which may also be empty or hold a text
+    struct TLog_Numbers {
+        std::vector<double> values;
+        std::vector<NLog_Value> kinds;
+        /// Dictionary ids of the texts, EMPTY where the value isn't a text
+        std::vector<std::uint32_t> texts;
+    };
+
+    /// Rows of a log stored by columns, every value is parsed once when the log is read
+    struct TLog_Columns {
+        /// Whole lines of the rows in the mapped log, used only to print them
+        std::vector<std::string_view> lines;
+        /// Number of tokens of every row, rows of different widths never match
+        std::vector<std::uint16_t> widths;
+        std::vector<std::int64_t> logicalClock;
+        /// Device time in seconds since 1970-01-01, NaN if it couldn't be parsed
+        std::vector<double> deviceTime;
+        /// Dictionary ids of the textual columns
+        std::vector<std::uint32_t> eventCode;
+        std::vector<std::uint32_t> signal;
+        std::vector<std::uint32_t> deviceId;
+        std::vector<std::uint32_t> rest;
+        /// Numeric columns, in the order of their positions
+        TLog_Numbers numbers[NLog_Column::Device_Id - NLog_Column::Info];
+
+        std::size_t size() const;
+        /// Reorders all columns, row i of the result is row order[i] of the original
+        void permute(const std::vector<std::size_t>& order);
+        /**
+         * Appends rows of given columns.
+         * @param other columns of the following part of the log
+         * @param ids ids of this columns' dictionary indexed by the ids used by the other columns
+         */
+        void append(const TLog_Columns& other, const std::vector<std::uint32_t>& ids);
+    };
+
+    /**
+     * Log file read into typed columns. Texts are interned into given dictionary and rows keep views
+     * into the mapped file, so the dictionary and the rows are valid only as long as the log exists.
+     *
+     * Large logs are split at line breaks into chunks, which are parsed in parallel with their own dictionaries
+     * and then merged in order, so the rows are the same as if the log was parsed by a single thread.
+     */
+    class LogColumns {
+    private:
+        LogReader m_reader;
+        LogDictionary& m_dictionary;
+        TLog_Line m_header;
+        bool m_empty = true;
+        TLog_Columns m_columns;
+
+        /// Appends given line as a new row of given columns
+        static void appendRow(TLog_Columns& columns, LogDictionary& dictionary, std::string_view line, const TLog_Line& tokens);
+    public:
+        /// Smallest part of a log parsed by its own thread
+        static constexpr std::size_t MIN_CHUNK_SIZE = 1024 * 1024;
+
+        /**
+         * Reads log file at given path.
+         * @param logPath path to a log file
+         * @param dictionary dictionary the texts are interned into, may be shared with logs read at the same time
+         * @param threads maximum number of threads parsing the log, 0 = one per hardware thread
+         * @throws std::runtime_error if the file can't be opened
+         */
+        LogColumns(const std::string& logPath, LogDictionary& dictionary, std::size_t threads = 0);
+
+        /// Returns true if the log doesn't contain even the header
+        bool isEmpty() const;
+        const TLog_Line& getHeader() const;
+        const TLog_Columns& getColumns() const;
+        /// Returns tokens of given row
+        TLog_Line getRow(std::size_t row) const;
+        /// Sorts the rows by their logical clock, rows with equal logical clock keep their order
+        void sortByLogicalClock();
+    };
+}
+
+#endif //SMARTTESTER_LOGCOLUMNS_H
@@ -0,0 +1,81 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_LOGCOMPARATOR_H
+#define SMARTTESTER_LOGCOMPARATOR_H
+
+#include <vector>
+#include <cstdint>
+#include "LogColumns.h"
+#include "ComparisonSchema.h"
+
+namespace tester {
+
+    /// Outcome of comparison of a result log with a reference log
+    struct TLog_Comparison {
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        /// Reference rows which weren't found in the result log, in the order of the reference log
+        std::vector<std::size_t> missing;
+        /// Result rows which weren't matched with any reference row, in the order of the result log
+        std::vector<std::size_t> redundant;
+        /// Result row found where the first missing reference row was expected, npos if there was none
+        std::size_t firstMismatch = npos;
+    };
+
+    /**
+     * Compares a result log with a reference log, both sorted by logical clock and sharing one dictionary.
+     * Reference rows are matched in order - every reference row is matched with the first equal result row
+     * following the result row matched with the previous reference row. Compared columns start
+     * at cnst::firstComparedIndex and the numeric ones are compared with the tolerances of a ComparisonSchema.
+     *
+     * Logs of an unchanged scenario are usually equal row by row, which is checked first by a pass over whole
+     * columns, vectorized by the compiler. Otherwise the result log is indexed once by a hash of its compared
+     * columns, with the values of columns with absolute tolerance quantized into cells wider than the tolerance,
+     * so every reference row only looks up the rows in its own cells, and in the neighbouring ones when its values
+     * lie near the edges. The comparison is then O(n log n) instead of quadratic in the number of rows.
+     */
+    class LogComparator {
+    private:
+        static constexpr std::size_t NUMERIC_COLUMNS = ComparisonSchema::NUMERIC_COLUMNS;
+
+        /// Tolerances of the numeric columns
+        TTolerance m_tolerances[NUMERIC_COLUMNS];
+        /// Tolerances of the numeric columns indexed by dictionary id of the signal, empty if no signal overrides them
+        std::vector<TTolerance> m_signalTolerances[NUMERIC_COLUMNS];
+        /// Width of the cells values of a numeric column are quantized into, 0 if the column isn't hashed
+        double m_cellWidths[NUMERIC_COLUMNS] = {};
+
+        /// Returns tolerance of given numeric column for rows of given signal
+        const TTolerance& getTolerance(std::size_t slot, std::uint32_t signal) const;
+        /// Returns true if every row of the result log matches the reference row at the same position
+        bool matchesAligned(const TLog_Columns& result, const TLog_Columns& reference) const;
+    public:
+        /**
+         * @param schema tolerances of the numeric columns
+         * @param dictionary dictionary of the compared logs, the signals of the schema are looked up in it
+         */
+        LogComparator(const ComparisonSchema& schema, const LogDictionary& dictionary);
+
+        /**
+         * Checks whether given result row matches given reference row.
+         * @param result columns of the result log
+         * @param resultRow row of the result log
+         * @param reference columns of the reference log
+         * @param referenceRow row of the reference log
+         * @return true if all compared columns are equal, numeric ones within their tolerance
+         */
+        bool rowsMatch(const TLog_Columns& result, std::size_t resultRow,
+                       const TLog_Columns& reference, std::size_t referenceRow) const;
+        /**
+         * Matches rows of the reference log with rows of the result log.
+         * @param result sorted result log
+         * @param reference sorted reference log
+         * @return missing and redundant rows
+         */
+        TLog_Comparison compare(const TLog_Columns& result, const TLog_Columns& reference) const;
+    };
+}
+
+#endif //SMARTTESTER_LOGCOMPARATOR_H
@@ -0,0 +1,82 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_LOGREADER_H
+#define SMARTTESTER_LOGREADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+
+namespace tester {
+
+    /// Tokens of one line of a log file
+    using TLog_Line = std::vector<std::string_view>;
+    /// Tokenized lines of a log file, the first one being the header
+    using TLog_Lines = std::vector<TLog_Line>;
+
+    /**
+     * Reads a log file by mapping it into the memory and splits its lines into tokens, which are views into
+     * the mapping, so no field of the log is copied. Tokens are separated by "; " and the part of a line
+     * following the last separator isn't a token.
+     *
+     * Lines may be scanned one by one without keeping their tokens, or tokenized all at once.
+     * Tokens are valid only as long as the reader exists, so it can't be copied.
+     */
+    class LogReader {
+    private:
+        /// Beginning and size of the mapped file
+        const char* m_data = nullptr;
+        std::size_t m_size = 0;
+#ifdef _WIN32
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+#endif
+        TLog_Lines m_lines;
+        bool m_tokenized = false;
+
+        /// Unmaps the file and closes it
+        void close();
+    public:
+        /**
+         * Maps log file at given path.
+         * @param logPath path to a log file
+         * @throws std::runtime_error if the file can't be opened or mapped
+         */
+        explicit LogReader(const std::string& logPath);
+        ~LogReader();
+
+        LogReader(const LogReader&) = delete;
+        LogReader& operator=(const LogReader&) = delete;
+
+        /**
+         * Splits given line into tokens.
+         * @param line line of a log without the line break
+         * @param tokens receives the tokens, previous content is replaced
+         */
+        static void tokenize(std::string_view line, TLog_Line& tokens);
+        /**
+         * Calls given callback for every line of given text in order. The tokens are reused between the calls.
+         * @param text whole lines of a log
+         * @param callback receives the whole line and its tokens
+         */
+        static void forEachLine(std::string_view text, const std::function<void(std::string_view line, const TLog_Line& tokens)>& callback);
+        /// Calls given callback for every line of the file in order
+        void forEachLine(const std::function<void(std::string_view line, const TLog_Line& tokens)>& callback) const;
+        /// Returns the whole mapped file
+        std::string_view getText() const;
+        /**
+         * Splits given text into chunks of similar size, which end after a line break, so no line is split.
+         * @param text whole lines of a log
+         * @param count requested number of chunks, less chunks are returned if there isn't enough lines
+         * @return non-empty chunks in the order of the text
+         */
+        static std::vector<std::string_view> splitLines(std::string_view text, std::size_t count);
+        /// Returns all lines tokenized, they are tokenized on the first call
+        TLog_Lines& getLines();
+    };
+}
+
+#endif //SMARTTESTER_LOGREADER_H
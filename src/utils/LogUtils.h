@@ -12,36 +12,22 @@
 #include "Logger.h"
 #include "constants.h"
 #include "UnitTestExecUtils.h"
+#include "LogReader.h"
 
 namespace log {
 
-    /// Prints result information into the console and log
-    void printResult(const HRESULT result);
+    /// Prints result information into the console (or given console streams) and log
+    void printResult(const HRESULT result, std::wostream& output = std::wcout, std::wostream& errorOutput = std::wcerr);
     /// Error logs given line
-    void errorLogLine(const std::vector<std::string>& line);
+    void errorLogLine(const tester::TLog_Line& line);
     /// Info logs given line
-    void infoLogLine(const std::vector<std::string> &line);
+    void infoLogLine(const tester::TLog_Line& line);
     /// Info logs given lines
-    void infoLogLines(const std::vector<std::vector<std::string>>& lines);
+    void infoLogLines(const tester::TLog_Lines& lines);
     /// Prints errors into the log and console and empties the container
     void printAndEmptyErrors(const refcnt::Swstr_list& errors);
     /// Logs the error information about failed filter configuration
     void logConfigurationError(const tester::FilterConfig &config, HRESULT expected, HRESULT result);
-    /**
-     * Reads log file at given path and transforms it into individual tokens.
-     *
-     * @param logPath path to a log file
-     * @return vector of vectors representing individual lines
-     */
-    std::vector<std::vector<std::string>> readLogFile(const std::string& logPath);
-    /**
-     * Compares given lines from result log and the reference log.
-     *
-     * @param resultLogLine line from the result log
-     * @param referenceLogLine line from the reference log
-     * @return true if the lines are identical, otherwise false
-     */
-    bool compareLines(const std::vector<std::string>& resultLogLine, const std::vector<std::string>& referenceLogLine);
 
 }
 
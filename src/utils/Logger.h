@@ -8,6 +8,7 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <mutex>
 
     /**
 	Class Logger is used to simplify logging of runtime information into a file.
@@ -28,12 +29,21 @@
 
         static Logger &getInstance();
 
+        /// Returns the directory the logs are written into
+        static std::string getLogDirectory();
+
     private:
         Logger();
 
         void log(const std::wstring& text, const std::wstring& level);
 
+        /// Fork handlers keeping the mutex consistent in child processes forked while other thread logs
+        static void lockBeforeFork();
+        static void unlockAfterFork();
+
         std::wofstream m_stream;
+        /// Guards the stream, testers of different filters may log from multiple threads at once
+        std::mutex m_mutex;
     };
 
     std::string currentTime();
@@ -0,0 +1,64 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_RESOURCEMETER_H
+#define SMARTTESTER_RESOURCEMETER_H
+
+#include <chrono>
+
+namespace tester {
+
+    /// Resources consumed by a single test
+    struct TTest_Metrics {
+        /// Elapsed real time in milliseconds
+        double wallTime = 0.0;
+        /// CPU time spent in user mode in milliseconds
+        double userTime = 0.0;
+        /// CPU time spent in kernel mode in milliseconds
+        double systemTime = 0.0;
+        /// Growth of the process' peak resident set size in kilobytes
+        long peakRssDelta = 0;
+        long voluntaryContextSwitches = 0;
+        long involuntaryContextSwitches = 0;
+    };
+
+    /// Current resource usage of the whole process
+    struct TProcess_Usage {
+        /// Current resident set size in kilobytes, -1 if it can't be measured on this platform
+        long rss = -1;
+        /// Number of open file descriptors, -1 if it can't be measured on this platform
+        long openFiles = -1;
+    };
+
+    /**
+     * Samples current resource usage of the process. Unlike the peak RSS reported by ResourceMeter,
+     * the current RSS also drops when memory is returned to the system, so it shows slow growth over time.
+     * @return current resource usage
+     */
+    TProcess_Usage sampleProcessUsage();
+
+    /**
+     * Measures resources consumed by the calling thread between construction and the stop() call. CPU time and context
+     * switches are counted for the calling thread only where the platform allows it, so tests executed
+     * in parallel don't affect each other's numbers, unless the whole process is requested to be measured.
+     * Peak RSS is always process-wide.
+     */
+    class ResourceMeter {
+    private:
+        const bool m_processWide;
+        TTest_Metrics m_start;
+        std::chrono::steady_clock::time_point m_startTime;
+
+        TTest_Metrics sample() const;
+    public:
+        /**
+         * @param processWide whether CPU time and context switches of all threads of the process should be counted
+         */
+        explicit ResourceMeter(bool processWide = false);
+        /// Returns resources consumed since the construction
+        TTest_Metrics stop() const;
+    };
+}
+
+#endif //SMARTTESTER_RESOURCEMETER_H
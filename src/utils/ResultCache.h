@@ -0,0 +1,99 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_RESULTCACHE_H
+#define SMARTTESTER_RESULTCACHE_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <cstdint>
+#include <rtl/hresult.h>
+#include <rtl/FilesystemLib.h>
+
+namespace tester {
+
+    /**
+     * Singleton remembering which tests passed with which inputs. Inputs of a test are summarized by a content hash
+     * of every file that can influence its result - the tested filter library, scgms library and the tester itself,
+     * and the scenario files for regression tests. A test which passed with the same inputs before doesn't have
+     * to be executed again. Failed tests are never cached, so they are always executed.
+     * The cache is kept in a file in the log directory across runs and is used only when enabled.
+     */
+    class ResultCache {
+    private:
+        /// Guards the cache, testers may run in parallel
+        std::mutex m_mutex;
+        bool m_enabled;
+        bool m_loaded;
+        /// Path to the tester executable
+        std::string m_executable;
+        /// Input hashes of passed tests, mapped to test key
+        std::map<std::wstring, std::uint64_t> m_passed;
+        /// Content hashes of already hashed files, mapped to path
+        std::map<std::wstring, std::uint64_t> m_fileHashes;
+
+        ResultCache();
+        static std::string getCachePath();
+        static std::wstring makeKey(const std::wstring& suite, const std::wstring& name);
+        void load();
+        /// Returns path to the running executable, given path if it can't be determined
+        static std::string resolveExecutable(const std::string& executable);
+        /// Returns content hash of given file, NO_HASH if it can't be read. Expects the mutex to be locked.
+        std::uint64_t hashFile(const filesystem::path& path);
+        /**
+         * Mixes given file's path and content hash into the hash. Expects the mutex to be locked.
+         * @return false if the file can't be read
+         */
+        bool mixFile(std::uint64_t& hash, const filesystem::path& path);
+    public:
+        /// Hash of inputs which couldn't all be read, tests with such inputs are never cached
+        static constexpr std::uint64_t NO_HASH = 0;
+
+        static ResultCache& getInstance();
+        /**
+         * Enables the cache.
+         * @param executable path the tester was started with (argv[0]), the real path of the running executable
+         * is hashed as part of inputs of every test
+         */
+        void enable(const std::string& executable);
+        bool isEnabled();
+        /**
+         * Returns hash of inputs of unit tests of a filter.
+         * @param libraryFile path to the library with the tested filter
+         * @return NO_HASH if some of the inputs can't be read
+         */
+        std::uint64_t hashUnitInputs(const std::wstring& libraryFile);
+        /**
+         * Returns hash of inputs of a regression scenario - every file in the scenario directory (configuration,
+         * input data and reference log) and every filter library which the configuration may load.
+         * @param scenarioDirectory directory with the scenario configuration
+         * @return NO_HASH if some of the inputs can't be read
+         */
+        std::uint64_t hashRegressionInputs(const filesystem::path& scenarioDirectory);
+        /**
+         * Checks whether given test already passed with given inputs.
+         * @param suite name of the suite
+         * @param name name of the test
+         * @param inputHash hash of current inputs of the test
+         * @return true if the test doesn't have to be executed, never for NO_HASH
+         */
+        bool hasPassed(const std::wstring& suite, const std::wstring& name, std::uint64_t inputHash);
+        /**
+         * Records result of executed test.
+         * @param suite name of the suite
+         * @param name name of the test
+         * @param inputHash hash of inputs the test was executed with
+         * @param result result of the test, only S_OK with inputs other than NO_HASH is cached
+         */
+        void record(const std::wstring& suite, const std::wstring& name, std::uint64_t inputHash, HRESULT result);
+        /// Writes the cache into the cache file, if it's enabled
+        void save();
+
+        ResultCache(ResultCache const&) = delete;
+        void operator=(ResultCache const&) = delete;
+    };
+}
+
+#endif //SMARTTESTER_RESULTCACHE_H
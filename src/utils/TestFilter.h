@@ -5,25 +5,75 @@
 #ifndef SMARTTESTER_TESTFILTER_H
 #define SMARTTESTER_TESTFILTER_H
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
 #include <iface/FilterIface.h>
 #include <rtl/referencedImpl.h>
 
 /**
  * Class representing our custom test filter. This filter is appended to the tested filter and it's only function
- * is to "catch" executed event and store it in attribute, so we can check it in the test function later.
+ * is to "catch" executed events and store them, so we can check them in the test function later.
+ * Events are stored in a preallocated lock-free ring buffer, so the tested filter may emit them from any number
+ * of its own threads. When the buffer is full, the oldest events are overwritten.
  */
 class TestFilter : public virtual scgms::IFilter, public virtual refcnt::CNotReferenced {
 
     using IFilter_Configuration = refcnt::IVector_Container<scgms::IFilter_Parameter*>;
-private:
+public:
+    /// Default number of events kept in the buffer
+    static constexpr std::size_t DEFAULT_CAPACITY = 65536;
+
     /// Event that the filter we are appended to executed
-    scgms::TDevice_Event m_receivedEvent;
+    struct TReceived_Event {
+        /// Copy of the event data. Pointers to the event's info and parameters are not valid anymore.
+        scgms::TDevice_Event event;
+        /// Order in which the event arrived, starting from zero since the last reset
+        std::uint64_t sequence;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+private:
+    /// Slot of the ring buffer, the stamp tells which sequence the slot holds and whether it's being written
+    struct TSlot {
+        std::atomic<std::uint64_t> stamp{0};
+        TReceived_Event entry;
+    };
+
+    std::unique_ptr<TSlot[]> m_slots;
+    std::size_t m_capacity;
+    /// Sequence number of the next received event
+    std::atomic<std::uint64_t> m_next;
+
+    /// Copies the event with given sequence into entry, returns false if it isn't in the buffer (anymore)
+    bool readEntry(std::uint64_t sequence, TReceived_Event& entry) const;
 public:
-    TestFilter();
+    explicit TestFilter(std::size_t capacity = DEFAULT_CAPACITY);
     ~TestFilter() override = default;
 
-    /// Returns a reference to the event data we got from the tested filter.
-    const scgms::TDevice_Event& getReceivedEvent();
+    /// Forgets all received events. Must not be called while the tested filter may emit events.
+    void reset();
+    /// Forgets all received events and changes the capacity of the buffer. Same restrictions as reset() apply.
+    void reset(std::size_t capacity);
+    /// Returns the last event we got from the tested filter, zeroed event if there was none.
+    scgms::TDevice_Event getReceivedEvent() const;
+    /// Returns number of events received since the last reset, including the overwritten ones.
+    std::uint64_t getReceivedCount() const;
+    /// Returns number of received events that were overwritten, because the buffer was full.
+    std::uint64_t getOverwrittenCount() const;
+    std::size_t getCapacity() const;
+    /// Returns the received events that are still in the buffer, in the order of their arrival.
+    std::vector<TReceived_Event> getReceivedEvents() const;
+    /// Returns number of events with given code that are still in the buffer.
+    std::size_t countReceived(scgms::NDevice_Event_Code eventCode) const;
+    /**
+     * Checks whether events with given codes arrived in given order, not necessarily one right after another.
+     * @param eventCodes expected order of event codes
+     * @return true if the buffer contains the event codes as a subsequence
+     */
+    bool receivedInOrder(const std::vector<scgms::NDevice_Event_Code>& eventCodes) const;
 
     HRESULT IfaceCalling Execute(scgms::IDevice_Event *event) final;
     HRESULT IfaceCalling Configure(IFilter_Configuration* configuration, refcnt::wstr_list *error_description) final;
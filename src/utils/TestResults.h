@@ -0,0 +1,72 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_TESTRESULTS_H
+#define SMARTTESTER_TESTRESULTS_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <rtl/hresult.h>
+#include "ResourceMeter.h"
+
+namespace tester {
+
+    /// Outcome of a single executed test
+    struct TTest_Result {
+        /// Name of the tested filter
+        std::wstring suite;
+        /// Name of the test
+        std::wstring name;
+        HRESULT result = E_FAIL;
+        /// Set if the test didn't return on its own - e.g. TIMEOUT or CRASH
+        std::wstring abnormalEnd;
+        /// Set if the result was taken from ResultCache instead of executing the test
+        bool cached = false;
+        TTest_Metrics metrics;
+    };
+
+    /**
+     * Singleton collecting results of all executed tests, which can be written into machine-readable reports
+     * (JSON and JUnit XML) next to the text log at the end of the run.
+     */
+    class ResultCollector {
+    private:
+        /// Guards the results, testers may run in parallel
+        std::mutex m_mutex;
+        std::vector<TTest_Result> m_results;
+
+        ResultCollector() = default;
+        /// Returns collected results grouped by suite in a stable order
+        std::vector<TTest_Result> sortedResults();
+    public:
+        static ResultCollector& getInstance();
+        void add(TTest_Result result);
+        std::vector<TTest_Result> getResults();
+        /**
+         * Writes all collected results as JSON.
+         * @param path path to the written file
+         * @return true if the file was written
+         */
+        bool writeJson(const std::string& path);
+        /**
+         * Writes all collected results as JUnit XML.
+         * @param path path to the written file
+         * @return true if the file was written
+         */
+        bool writeJUnit(const std::string& path);
+        /**
+         * Writes both reports into the log directory, named after the current date and time.
+         */
+        void writeReports();
+
+        ResultCollector(ResultCollector const&) = delete;
+        void operator=(ResultCollector const&) = delete;
+    };
+
+    /// Returns the textual status of given test result, as printed to the console
+    std::wstring describeStatus(const TTest_Result& result);
+}
+
+#endif //SMARTTESTER_TESTRESULTS_H
@@ -0,0 +1,59 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_TESTSELECTION_H
+#define SMARTTESTER_TESTSELECTION_H
+
+#include <regex>
+#include <string>
+#include <cstdint>
+
+namespace tester {
+
+    /**
+     * Singleton deciding which tests are executed. A test is identified as "<suite>/<name>" - e.g. the tested filter
+     * and the name passed to executeTest - and is selected if it matches the optional pattern and belongs to this
+     * process' shard. Shards are derived from a stable hash of the identifier, so every process with the same
+     * shard count splits the tests in the same way, regardless of platform or order of execution.
+     * Has to be configured before any test is executed.
+     */
+    class TestSelection {
+    private:
+        std::wregex m_pattern;
+        bool m_hasPattern;
+        /// Zero-based index of the executed shard
+        unsigned int m_shardIndex;
+        unsigned int m_shardCount;
+
+        TestSelection();
+        static std::uint32_t hashIdentifier(const std::wstring& identifier);
+    public:
+        static TestSelection& getInstance();
+        /**
+         * Selects only tests whose identifier contains a match of given regular expression.
+         * @param pattern ECMAScript regular expression
+         * @throws std::regex_error if the pattern is not a valid regular expression
+         */
+        void setPattern(const std::wstring& pattern);
+        /**
+         * Selects only tests belonging to given shard.
+         * @param index zero-based index of the shard, lower than the count
+         * @param count total number of shards
+         * @throws std::invalid_argument if the index or count is invalid
+         */
+        void setShard(unsigned int index, unsigned int count);
+        /**
+         * Decides whether given test should be executed.
+         * @param suite name of the suite - the tested filter, or the kind of tests
+         * @param name name of the test
+         * @return true if the test is selected
+         */
+        bool isSelected(const std::wstring& suite, const std::wstring& name) const;
+
+        TestSelection(TestSelection const&) = delete;
+        void operator=(TestSelection const&) = delete;
+    };
+}
+
+#endif //SMARTTESTER_TESTSELECTION_H
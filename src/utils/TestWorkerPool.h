@@ -0,0 +1,99 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_TESTWORKERPOOL_H
+#define SMARTTESTER_TESTWORKERPOOL_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+#include <rtl/hresult.h>
+#include "TimerWheel.h"
+
+namespace tester {
+
+    /**
+     * Singleton pool of long-lived worker threads executing tests. Timeouts of all running tests are watched
+     * by a single supervisor thread, which drives a timer wheel, instead of a waiting thread per test.
+     * The supervisor ticks only while some test is running and sleeps otherwise.
+     */
+    class TestWorkerPool {
+    public:
+        using TJob_Id = uint64_t;
+
+        /// State of a submitted test, as seen by the thread waiting for it
+        enum class NJob_State {
+            Finished,
+            Timed_Out
+        };
+
+    private:
+        struct TJob {
+            std::function<HRESULT(void)> test;
+            long timeout;
+            HRESULT result = E_FAIL;
+            bool finished = false;
+            bool timedOut = false;
+        };
+
+        std::vector<std::thread> m_workers;
+        std::thread m_supervisor;
+        /// Guards the queue, jobs and the timer wheel
+        std::mutex m_mutex;
+        /// Notifies workers about queued jobs
+        std::condition_variable m_queueCv;
+        /// Notifies waiting threads about finished and timed out jobs
+        std::condition_variable m_jobCv;
+        /// Wakes up the supervisor when a timeout is scheduled or the pool is being stopped
+        std::condition_variable m_supervisorCv;
+        std::deque<TJob_Id> m_queue;
+        std::unordered_map<TJob_Id, TJob> m_jobs;
+        TimerWheel m_timerWheel;
+        TJob_Id m_nextJobId;
+        bool m_stopping;
+
+        TestWorkerPool();
+        void workerRoutine();
+        void supervisorRoutine();
+    public:
+        ~TestWorkerPool();
+        static TestWorkerPool& getInstance();
+        /**
+         * Makes sure there is at least given number of workers in the pool. Workers are never removed until
+         * the pool is destroyed.
+         * @param count minimal number of workers
+         */
+        void ensureWorkers(std::size_t count);
+        /**
+         * Queues the test for execution. The timeout starts counting once a worker picks the test up.
+         * @param test test to execute
+         * @param timeout maximum execution time in milliseconds
+         * @return identifier of the job to wait for
+         */
+        TJob_Id submit(std::function<HRESULT(void)> test, long timeout);
+        /**
+         * Blocks until the test finishes or its timeout expires. A finished job is released from the pool,
+         * a timed out one has to be collected by waitForCompletion.
+         * @param id identifier of the job
+         * @param result result of the test, valid only if the job finished
+         * @return state of the job
+         */
+        NJob_State waitFor(TJob_Id id, HRESULT &result);
+        /**
+         * Blocks until the test actually returns and releases the job from the pool.
+         * @param id identifier of the job
+         */
+        void waitForCompletion(TJob_Id id);
+
+        TestWorkerPool(TestWorkerPool const&) = delete;
+        void operator=(TestWorkerPool const&) = delete;
+    };
+}
+
+#endif //SMARTTESTER_TESTWORKERPOOL_H
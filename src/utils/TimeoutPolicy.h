@@ -0,0 +1,67 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_TIMEOUTPOLICY_H
+#define SMARTTESTER_TIMEOUTPOLICY_H
+
+#include <map>
+#include <mutex>
+#include <deque>
+#include <string>
+#include <vector>
+#include "TestResults.h"
+
+namespace tester {
+
+    /**
+     * Singleton deciding the timeout of every test. Without history the timeout is the one requested by the test
+     * itself, or the configured default. With adaptive timeouts enabled, tests with enough recorded durations get
+     * their 99th percentile multiplied by a factor instead, clamped into a sane range - so hung tests fail fast
+     * and slow but healthy tests don't time out.
+     * Durations of finished tests are kept in a history file in the log directory across runs.
+     */
+    class TimeoutPolicy {
+    private:
+        /// Guards the history and settings, testers may run in parallel
+        std::mutex m_mutex;
+        /// Recent durations in milliseconds, mapped to test key
+        std::map<std::wstring, std::deque<double>> m_history;
+        long m_defaultTimeout;
+        /// Multiplier of the 99th percentile, 0 if adaptive timeouts are disabled
+        double m_adaptiveFactor;
+        bool m_historyLoaded;
+
+        TimeoutPolicy();
+        static std::wstring makeKey(const std::wstring& suite, const std::wstring& name);
+        static std::string getHistoryPath();
+        void loadHistory();
+    public:
+        static TimeoutPolicy& getInstance();
+        /// Sets the timeout of tests that don't request their own, in milliseconds
+        void setDefaultTimeout(long timeout);
+        /**
+         * Enables timeouts derived from the recorded durations.
+         * @param factor multiplier of the 99th percentile of recorded durations, 0 disables adaptive timeouts
+         */
+        void setAdaptiveFactor(double factor);
+        /**
+         * Returns the timeout of given test.
+         * @param suite name of the tested filter
+         * @param name name of the test
+         * @param requestedTimeout timeout requested by the test itself in milliseconds, 0 for the default one
+         * @return timeout in milliseconds
+         */
+        long getTimeout(const std::wstring& suite, const std::wstring& name, long requestedTimeout);
+        /**
+         * Adds durations of normally finished tests into the history and writes it into the history file.
+         * @param results results of executed tests
+         */
+        void recordResults(const std::vector<TTest_Result>& results);
+
+        TimeoutPolicy(TimeoutPolicy const&) = delete;
+        void operator=(TimeoutPolicy const&) = delete;
+    };
+}
+
+#endif //SMARTTESTER_TIMEOUTPOLICY_H
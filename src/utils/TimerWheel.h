@@ -0,0 +1,65 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#ifndef SMARTTESTER_TIMERWHEEL_H
+#define SMARTTESTER_TIMERWHEEL_H
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+namespace tester {
+
+    /**
+     * Hashed timing wheel used for scheduling of test timeouts. Time is divided into ticks of fixed length and every
+     * scheduled timer is placed into the slot where it expires, together with the number of full wheel rounds
+     * remaining. Scheduling and expiring is O(1) per timer regardless of the number of running tests.
+     * The wheel itself is not thread-safe, the owner is responsible for the synchronization.
+     */
+    class TimerWheel {
+    private:
+        struct TTimer {
+            uint64_t id;
+            uint64_t rounds;
+        };
+
+        /// Slots of the wheel, each contains timers expiring when the wheel points at it
+        std::vector<std::vector<TTimer>> m_slots;
+        /// Length of one tick in milliseconds
+        const long m_tickLength;
+        /// Index of the slot processed by the next tick
+        std::size_t m_currentSlot;
+        /// Slots of the scheduled timers, mapped to their ids
+        std::unordered_map<uint64_t, std::size_t> m_timerSlots;
+    public:
+        /**
+         * @param slotCount number of slots of the wheel
+         * @param tickLength length of one tick in milliseconds
+         */
+        TimerWheel(std::size_t slotCount, long tickLength);
+
+        /**
+         * Schedules a timer with given id to expire after given time. Expiration is rounded up to whole ticks.
+         * @param id identifier of the timer, returned by advance() upon expiration
+         * @param timeout time to expiration in milliseconds
+         */
+        void schedule(uint64_t id, long timeout);
+        /**
+         * Advances the wheel by one tick.
+         * @return identifiers of timers that expired during this tick
+         */
+        std::vector<uint64_t> advance();
+        /**
+         * Removes a scheduled timer, so it never expires.
+         * @param id identifier of the timer
+         * @return false if there was no such timer
+         */
+        bool cancel(uint64_t id);
+        /// Returns true if no timer is scheduled
+        bool isEmpty() const;
+        long getTickLength() const;
+    };
+}
+
+#endif //SMARTTESTER_TIMERWHEEL_H
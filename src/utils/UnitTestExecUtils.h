@@ -4,6 +4,7 @@
 
 #ifndef SMARTTESTER_UNITTESTER_H
 #define SMARTTESTER_UNITTESTER_H
+#include <ostream>
 #include <rtl/guid.h>
 #include <rtl/FilesystemLib.h>
 #include "../testers/GenericUnitTester.h"
@@ -18,10 +19,68 @@ namespace tester {
     void executeFilterTests(const GUID &guid);
 
     /**
-     * Executes all defined unit tests across all filters.
+     * Executes all defined unit tests upon a filter with given GUID, printing the console output into given stream
+     * instead of the standard ones.
+     * @param guid guid of a filter that is to be tested
+     * @param output stream collecting the console output of the tester
      */
-    void executeAllTests();
+    void executeFilterTests(const GUID &guid, std::wostream &output);
 
+    /**
+     * Executes all defined unit tests across all filters. When more than one job is requested, testers of different
+     * filters are executed in parallel and their console output is printed in the order of GuidFileMapper's map.
+     * @param jobs number of testers executed at the same time, 0 means one per hardware thread
+     */
+    void executeAllTests(unsigned int jobs = 1);
+
+
+    /**
+     * Measures event throughput of a filter with given GUID, see GenericUnitTester::executeBenchmark.
+     * @param guid guid of a filter that is to be benchmarked
+     * @param eventCount number of events executed for every event code
+     * @return S_OK if the filter was benchmarked and accepted all events
+     */
+    HRESULT executeFilterBenchmark(const GUID &guid, std::size_t eventCount);
+
+    /**
+     * Measures event throughput of all filters known to GuidFileMapper, one after another.
+     * @param eventCount number of events executed for every event code
+     * @return S_OK if all filters were benchmarked and accepted all events
+     */
+    HRESULT executeAllBenchmarks(std::size_t eventCount);
+
+    /**
+     * Stress tests a filter with given GUID by executing events from multiple threads at once,
+     * see GenericUnitTester::executeStressTest.
+     * @param guid guid of a filter that is to be stress tested
+     * @param eventCount number of events executed with every thread count
+     * @param maxThreads maximum number of threads, 0 means one per hardware thread
+     * @return S_OK if no event was rejected, lost or duplicated
+     */
+    HRESULT executeFilterStressTest(const GUID &guid, std::size_t eventCount, unsigned int maxThreads);
+
+    /**
+     * Stress tests all filters known to GuidFileMapper, one after another.
+     * @param eventCount number of events executed with every thread count
+     * @param maxThreads maximum number of threads, 0 means one per hardware thread
+     * @return S_OK if no event was rejected, lost or duplicated by any filter
+     */
+    HRESULT executeAllStressTests(std::size_t eventCount, unsigned int maxThreads);
+
+    /**
+     * Executes given soak test upon filter with given GUID.
+     * @param guid guid of a filter that is to be soak tested
+     * @param soakTester soak test to execute
+     * @return S_OK if no growth of resources or latency drift was detected
+     */
+    HRESULT executeFilterSoakTest(const GUID &guid, const SoakTester& soakTester);
+
+    /**
+     * Loads scgms core library and libraries of all filters known to GuidFileMapper into this process. Child processes
+     * forked for individual tests then inherit them already loaded and initialized, instead of loading them again.
+     * @return true if all libraries were loaded
+     */
+    bool preloadLibraries();
 
     /// Returns a unit tester instance based on given guid
     tester::GenericUnitTester *getUnitTester(const GUID &guid);
@@ -8,10 +8,14 @@
 namespace cnst {
     //maximum execution time of each test in milliseconds
     constexpr long MAX_EXEC_TIME = 1000;
+    //maximum execution time of tests rendering images in milliseconds
+    constexpr long DRAWING_EXEC_TIME = 5000;
     //expected name of tested log file
     static const wchar_t* LOG_FILE = L"log.csv";
     //expected name of imported configuration file
     static const wchar_t* CONFIG_FILE = L"config.ini";
+    //optional tolerances of numeric log columns of a scenario, next to its configuration file
+    static const wchar_t* TOLERANCE_FILE = L"tolerance.csv";
     //temp directory name
     static const wchar_t* TMP_DIR = L"tmp";
     //regression log in temp directory
@@ -0,0 +1,123 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include "../AllocationCounter.h"
+
+/// The allocator is replaced only in builds configured with SMARTTESTER_ALLOCATION_COUNTING,
+/// other builds keep the stock one
+#if defined(__GLIBC__) && defined(ALLOCATION_COUNTING)
+#define INTERPOSE_ALLOCATOR
+#endif
+
+namespace {
+    /// Constant-initialized, so they are usable by allocations made before static initialization
+    std::atomic<bool> s_counting{false};
+    std::atomic<std::uint64_t> s_allocations{0};
+    std::atomic<std::uint64_t> s_bytes{0};
+
+    inline void countAllocation(const std::size_t size) {
+        if (s_counting.load(std::memory_order_relaxed)) {
+            s_allocations.fetch_add(1, std::memory_order_relaxed);
+            s_bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+}
+
+#ifdef INTERPOSE_ALLOCATOR
+
+extern "C" {
+    void* __libc_malloc(std::size_t size);
+    void* __libc_calloc(std::size_t count, std::size_t size);
+    void* __libc_realloc(void* pointer, std::size_t size);
+    void* __libc_memalign(std::size_t alignment, std::size_t size);
+    void* __libc_valloc(std::size_t size);
+    void* __libc_pvalloc(std::size_t size);
+    void __libc_free(void* pointer);
+
+    /// Interposed C library allocation functions, forwarding to glibc's implementation
+    void* malloc(std::size_t size) {
+        countAllocation(size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) {
+        countAllocation(count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, std::size_t size) {
+        countAllocation(size);
+        return __libc_realloc(pointer, size);
+    }
+
+    /// Aligned allocations, also used by aligned operator new
+    void* memalign(std::size_t alignment, std::size_t size) {
+        countAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(std::size_t alignment, std::size_t size) {
+        countAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** pointer, std::size_t alignment, std::size_t size) {
+        if (alignment == 0 || alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+            return EINVAL;
+        }
+
+        countAllocation(size);
+        void* memory = __libc_memalign(alignment, size);
+        if (memory == nullptr) {
+            return ENOMEM;
+        }
+        *pointer = memory;
+        return 0;
+    }
+
+    void* valloc(std::size_t size) {
+        countAllocation(size);
+        return __libc_valloc(size);
+    }
+
+    void* pvalloc(std::size_t size) {
+        countAllocation(size);
+        return __libc_pvalloc(size);
+    }
+
+    void free(void* pointer) {
+        __libc_free(pointer);
+    }
+}
+
+#endif
+
+namespace tester {
+
+    bool isAllocationCountingSupported() {
+#ifdef INTERPOSE_ALLOCATOR
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void startAllocationCounting() {
+        s_allocations.store(0, std::memory_order_relaxed);
+        s_bytes.store(0, std::memory_order_relaxed);
+        s_counting.store(true, std::memory_order_release);
+    }
+
+    TAllocation_Count stopAllocationCounting() {
+        s_counting.store(false, std::memory_order_release);
+
+        TAllocation_Count count;
+        count.allocations = s_allocations.load(std::memory_order_relaxed);
+        count.bytes = s_bytes.load(std::memory_order_relaxed);
+        return count;
+    }
+}
@@ -0,0 +1,174 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <chrono>
+#include <iostream>
+#include "../ChildProcess.h"
+#include "../Logger.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <utils/string_utils.h>
+#endif
+
+namespace tester {
+
+#ifdef _WIN32
+
+    bool isChildProcessSupported() {
+        return false;
+    }
+
+    NChild_State runInChildProcess(const std::function<HRESULT(void)>& test, long timeout, HRESULT& result,
+                                   TTest_Metrics& metrics, std::wstring& description) {
+        ResourceMeter meter;
+        result = test();
+        metrics = meter.stop();
+        return NChild_State::Finished;
+    }
+
+#else
+
+    /// Result of the test sent by the child process
+    struct TChild_Result {
+        HRESULT result;
+        TTest_Metrics metrics;
+    };
+
+    bool isChildProcessSupported() {
+        return true;
+    }
+
+    /// Describes how the child process with given wait status ended
+    static std::wstring describeTermination(const int status) {
+        if (WIFSIGNALED(status)) {
+            return L"terminated by signal " + std::to_wstring(WTERMSIG(status)) + L" (" + Widen_Char(strsignal(WTERMSIG(status))) + L")";
+        } else if (WIFEXITED(status)) {
+            return L"exited with code " + std::to_wstring(WEXITSTATUS(status)) + L" without sending the result";
+        }
+
+        return L"ended unexpectedly";
+    }
+
+    NChild_State runInChildProcess(const std::function<HRESULT(void)>& test, const long timeout, HRESULT& result,
+                                   TTest_Metrics& metrics, std::wstring& description) {
+        auto startTime = std::chrono::steady_clock::now();
+        int fds[2];
+        if (pipe(fds) != 0) {
+            description = L"could not create pipe: " + Widen_Char(strerror(errno));
+            return NChild_State::Crashed;
+        }
+
+        /// Child would print the parent's pending output again
+        std::wcout.flush();
+        std::wcerr.flush();
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            description = L"could not fork: " + Widen_Char(strerror(errno));
+            close(fds[0]);
+            close(fds[1]);
+            return NChild_State::Crashed;
+        }
+
+        if (pid == 0) {
+            close(fds[0]);
+
+            TChild_Result childResult{ E_FAIL, {} };
+            ResourceMeter meter(true);      /// Filters may run their own threads, the whole child is the test
+            try {
+                childResult.result = test();
+            } catch (const std::exception& ex) {
+                Logger::getInstance().error(L"Test threw an exception: " + Widen_Char(ex.what()));
+            }
+            childResult.metrics = meter.stop();
+
+            std::wcout.flush();
+            std::wcerr.flush();
+
+            const char* data = reinterpret_cast<const char*>(&childResult);
+            std::size_t written = 0;
+            while (written < sizeof(childResult)) {
+                ssize_t count = write(fds[1], data + written, sizeof(childResult) - written);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                } else if (count <= 0) {
+                    break;
+                }
+                written += count;
+            }
+
+            close(fds[1]);
+            _exit(0);    /// Skipping atexit handlers and static destructors, they belong to the parent
+        }
+
+        close(fds[1]);
+
+        TChild_Result childResult{ E_FAIL, {} };
+        char* data = reinterpret_cast<char*>(&childResult);
+        std::size_t received = 0;
+        bool timedOut = false;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+        while (received < sizeof(childResult)) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                timedOut = true;
+                break;
+            }
+
+            pollfd pipeFd{ fds[0], POLLIN, 0 };
+            int ready = poll(&pipeFd, 1, static_cast<int>(remaining.count()));
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            } else if (ready == 0) {
+                timedOut = true;
+                break;
+            } else if (ready < 0) {
+                break;
+            }
+
+            ssize_t count = read(fds[0], data + received, sizeof(childResult) - received);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            } else if (count <= 0) {    /// Child closed the pipe without sending whole result
+                break;
+            }
+            received += count;
+        }
+
+        if (timedOut) {
+            kill(pid, SIGKILL);
+        }
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+            //
+        }
+        close(fds[0]);
+
+        if (timedOut || received < sizeof(childResult)) {
+            metrics = TTest_Metrics{};
+            metrics.wallTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+            if (timedOut) {
+                return NChild_State::Timed_Out;
+            }
+
+            description = describeTermination(status);
+            return NChild_State::Crashed;
+        }
+
+        result = childResult.result;
+        metrics = childResult.metrics;
+        return NChild_State::Finished;
+    }
+
+#endif
+}
@@ -0,0 +1,136 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include "../ComparisonSchema.h"
+
+namespace tester {
+
+    namespace {
+        /// Names of the numeric columns in the log header
+        const char* const COLUMN_NAMES[ComparisonSchema::NUMERIC_COLUMNS] = { "Info", "Segment Id", "Event Code Id" };
+
+        /// Maps bits of given double onto an integer, so the integers of adjacent doubles differ by one
+        std::int64_t orderedBits(const double value) {
+            std::int64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits < 0 ? -(bits & INT64_MAX) : bits;
+        }
+
+        std::string trim(const std::string& text) {
+            const std::size_t begin = text.find_first_not_of(" \t\r");
+            if (begin == std::string::npos) {
+                return std::string();
+            }
+            return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+        }
+
+        /// Throws an exception describing invalid line of the schema file
+        [[noreturn]] void invalidLine(const std::string& path, const std::size_t lineNumber, const std::string& reason) {
+            throw std::invalid_argument(path + ":" + std::to_string(lineNumber) + ": " + reason);
+        }
+    }
+
+    bool TTolerance::accepts(const double expected, const double actual) const {
+        switch (kind) {
+            case NTolerance_Kind::Relative:
+                return !(std::fabs(actual - expected) > value * std::max(std::fabs(expected), std::fabs(actual)));
+            case NTolerance_Kind::Ulp: {
+                const std::int64_t a = orderedBits(expected);
+                const std::int64_t b = orderedBits(actual);
+                const std::uint64_t distance = a > b ? static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b)
+                                                     : static_cast<std::uint64_t>(b) - static_cast<std::uint64_t>(a);
+                return !(static_cast<double>(distance) > value);
+            }
+            default:
+                return !(std::fabs(actual - expected) > value);
+        }
+    }
+
+    ComparisonSchema::ComparisonSchema() {
+        for (TTolerance& tolerance : m_columns) {
+            tolerance = { NTolerance_Kind::Absolute, DEFAULT_TOLERANCE };
+        }
+    }
+
+    ComparisonSchema ComparisonSchema::fromFile(const std::string& path) {
+        ComparisonSchema schema;
+        std::ifstream file(path);
+        std::string line;
+        for (std::size_t lineNumber = 1; std::getline(file, line); lineNumber++) {     /// column; kind; tolerance[; signal]
+            line = trim(line);
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+
+            std::vector<std::string> fields;
+            std::istringstream tokens(line);
+            for (std::string field; std::getline(tokens, field, ';'); ) {
+                fields.push_back(trim(field));
+            }
+            if (fields.size() < 3 || fields.size() > 4) {
+                invalidLine(path, lineNumber, "expected <column>; <kind>; <tolerance>[; <signal>]");
+            }
+
+            const auto name = std::find(std::begin(COLUMN_NAMES), std::end(COLUMN_NAMES), fields[0]);
+            if (name == std::end(COLUMN_NAMES)) {
+                invalidLine(path, lineNumber, "unknown numeric column " + fields[0]);
+            }
+
+            TTolerance tolerance;
+            if (fields[1] == "absolute") {
+                tolerance.kind = NTolerance_Kind::Absolute;
+            } else if (fields[1] == "relative") {
+                tolerance.kind = NTolerance_Kind::Relative;
+            } else if (fields[1] == "ulp") {
+                tolerance.kind = NTolerance_Kind::Ulp;
+            } else {
+                invalidLine(path, lineNumber, "unknown tolerance kind " + fields[1]);
+            }
+
+            std::size_t parsed = 0;
+            try {
+                tolerance.value = std::stod(fields[2], &parsed);
+            } catch (const std::exception&) {
+                parsed = 0;
+            }
+            if (parsed == 0 || parsed != fields[2].size() || !(tolerance.value >= 0.0)) {
+                invalidLine(path, lineNumber, "tolerance must be a non-negative number, not " + fields[2]);
+            }
+
+            const auto column = static_cast<NLog_Column>(NLog_Column::Info + (name - std::begin(COLUMN_NAMES)));
+            schema.setTolerance(column, tolerance, fields.size() == 4 ? fields[3] : std::string());
+        }
+
+        return schema;
+    }
+
+    void ComparisonSchema::setTolerance(const NLog_Column column, const TTolerance& tolerance, const std::string& signal) {
+        if (column < NLog_Column::Info || column >= NLog_Column::Device_Id) {
+            throw std::invalid_argument("Only numeric columns have a tolerance!");
+        }
+
+        const std::size_t slot = column - NLog_Column::Info;
+        if (signal.empty()) {
+            m_columns[slot] = tolerance;
+        } else {
+            m_signals[slot][signal] = tolerance;
+        }
+    }
+
+    const TTolerance& ComparisonSchema::getTolerance(const std::size_t slot) const {
+        return m_columns[slot];
+    }
+
+    const std::map<std::string, TTolerance>& ComparisonSchema::getSignalTolerances(const std::size_t slot) const {
+        return m_signals[slot];
+    }
+}
@@ -0,0 +1,45 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include "../CountingFilter.h"
+
+CountingFilter::CountingFilter() {
+    for (auto& count : m_counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+HRESULT IfaceCalling CountingFilter::Configure(IFilter_Configuration* configuration, refcnt::wstr_list *error_description) {
+    return S_OK;
+}
+
+HRESULT IfaceCalling CountingFilter::Execute(scgms::IDevice_Event *event) {
+    if (event == nullptr) {
+        return S_FALSE;
+    }
+
+    scgms::TDevice_Event *rawEvent;
+    event->Raw(&rawEvent);
+
+    const auto code = static_cast<std::size_t>(rawEvent->event_code);
+    if (code < CODE_COUNT) {
+        m_counts[code].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    event->Release();
+    return S_OK;
+}
+
+std::uint64_t CountingFilter::getCount(const scgms::NDevice_Event_Code eventCode) const {
+    const auto code = static_cast<std::size_t>(eventCode);
+    return code < CODE_COUNT ? m_counts[code].load(std::memory_order_relaxed) : 0;
+}
+
+std::uint64_t CountingFilter::getTotal() const {
+    std::uint64_t total = 0;
+    for (const auto& count : m_counts) {
+        total += count.load(std::memory_order_relaxed);
+    }
+    return total;
+}
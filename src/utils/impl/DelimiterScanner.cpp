@@ -0,0 +1,144 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include "../DelimiterScanner.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SCAN_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace tester {
+
+    namespace {
+        /// Returns index of the lowest set bit, the mask mustn't be zero
+        inline unsigned lowestBit(const std::uint32_t mask) {
+#ifdef _MSC_VER
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return static_cast<unsigned>(index);
+#else
+            return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+        }
+
+        /// Appends positions of the set bits of given mask, offset by given base
+        inline void appendMask(std::uint32_t mask, const std::uint32_t base, std::vector<std::uint32_t>& positions) {
+            while (mask != 0) {
+                positions.push_back(base + lowestBit(mask));
+                mask &= mask - 1;
+            }
+        }
+
+        void scanScalar(const std::string_view text, std::size_t from, std::vector<std::uint32_t>& positions) {
+            for (; from < text.size(); from++) {
+                if (text[from] == DelimiterScanner::DELIMITER || text[from] == DelimiterScanner::LINE_BREAK) {
+                    positions.push_back(static_cast<std::uint32_t>(from));
+                }
+            }
+        }
+
+#ifdef SCAN_X86
+        void scanSse2(const std::string_view text, std::vector<std::uint32_t>& positions) {
+            const __m128i delimiter = _mm_set1_epi8(DelimiterScanner::DELIMITER);
+            const __m128i lineBreak = _mm_set1_epi8(DelimiterScanner::LINE_BREAK);
+            std::size_t i = 0;
+            for (; i + 16 <= text.size(); i += 16) {
+                const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+                const __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(block, delimiter), _mm_cmpeq_epi8(block, lineBreak));
+                appendMask(static_cast<std::uint32_t>(_mm_movemask_epi8(matches)), static_cast<std::uint32_t>(i), positions);
+            }
+            scanScalar(text, i, positions);
+        }
+
+#if defined(__GNUC__) || defined(__clang__)
+        __attribute__((target("avx2")))
+#endif
+        void scanAvx2(const std::string_view text, std::vector<std::uint32_t>& positions) {
+            const __m256i delimiter = _mm256_set1_epi8(DelimiterScanner::DELIMITER);
+            const __m256i lineBreak = _mm256_set1_epi8(DelimiterScanner::LINE_BREAK);
+            std::size_t i = 0;
+            for (; i + 32 <= text.size(); i += 32) {
+                const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+                const __m256i matches = _mm256_or_si256(_mm256_cmpeq_epi8(block, delimiter), _mm256_cmpeq_epi8(block, lineBreak));
+                appendMask(static_cast<std::uint32_t>(_mm256_movemask_epi8(matches)), static_cast<std::uint32_t>(i), positions);
+            }
+            scanScalar(text, i, positions);
+        }
+
+        bool hasAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;     /// OSXSAVE and YMM state
+            __cpuidex(info, 7, 0);
+            return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+            return false;
+#endif
+        }
+#endif
+    }
+
+    NScan_Isa DelimiterScanner::getBestIsa() {
+        static const NScan_Isa best = isSupported(NScan_Isa::AVX2) ? NScan_Isa::AVX2
+                                      : isSupported(NScan_Isa::SSE2) ? NScan_Isa::SSE2 : NScan_Isa::Scalar;
+        return best;
+    }
+
+    bool DelimiterScanner::isSupported(const NScan_Isa isa) {
+        switch (isa) {
+#ifdef SCAN_X86
+            case NScan_Isa::AVX2: {
+                static const bool avx2 = hasAvx2();
+                return avx2;
+            }
+            case NScan_Isa::SSE2:
+                return true;
+#endif
+            case NScan_Isa::Scalar:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    std::wstring DelimiterScanner::describe(const NScan_Isa isa) {
+        switch (isa) {
+            case NScan_Isa::AVX2:
+                return L"AVX2";
+            case NScan_Isa::SSE2:
+                return L"SSE2";
+            default:
+                return L"scalar";
+        }
+    }
+
+    void DelimiterScanner::scan(const std::string_view text, std::vector<std::uint32_t>& positions, const NScan_Isa isa) {
+        positions.clear();
+        switch (isa) {
+#ifdef SCAN_X86
+            case NScan_Isa::AVX2:
+                scanAvx2(text, positions);
+                break;
+            case NScan_Isa::SSE2:
+                scanSse2(text, positions);
+                break;
+#endif
+            default:
+                scanScalar(text, 0, positions);
+                break;
+        }
+    }
+}
@@ -0,0 +1,148 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <iomanip>
+#include "../EventAuditor.h"
+#include "../Logger.h"
+
+namespace tester {
+
+    namespace {
+        /// Scope into which the events created by the current thread are counted
+        thread_local std::shared_ptr<TEvent_Audit> t_scope;
+
+        /**
+         * Proxy of a device event counting its own references. The wrapped event is released together
+         * with the last reference to the proxy, which is then counted as released in its scope.
+         */
+        class CAudited_Event : public virtual scgms::IDevice_Event {
+        private:
+            scgms::IDevice_Event* m_event;
+            std::shared_ptr<TEvent_Audit> m_audit;
+            std::atomic<ULONG> m_references{1};
+        public:
+            CAudited_Event(scgms::IDevice_Event* event, std::shared_ptr<TEvent_Audit> audit)
+                    : m_event(event), m_audit(std::move(audit)) {
+                m_audit->created.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            HRESULT IfaceCalling QueryInterface(const GUID* riid, void** ppvObj) override {
+                return m_event->QueryInterface(riid, ppvObj);
+            }
+
+            ULONG IfaceCalling AddRef() override {
+                return m_references.fetch_add(1, std::memory_order_relaxed) + 1;
+            }
+
+            ULONG IfaceCalling Release() override {
+                const ULONG references = m_references.fetch_sub(1, std::memory_order_acq_rel) - 1;
+                if (references == 0) {
+                    m_event->Release();
+                    m_audit->released.fetch_add(1, std::memory_order_relaxed);
+                    delete this;
+                }
+                return references;
+            }
+
+            HRESULT IfaceCalling Raw(scgms::TDevice_Event** dst) override {
+                return m_event->Raw(dst);
+            }
+
+            HRESULT IfaceCalling Clone(scgms::IDevice_Event** event) const override {
+                scgms::IDevice_Event* clone;
+                HRESULT result = m_event->Clone(&clone);
+                if (Succeeded(result)) {    /// Clones are owned by the filter which made them, so they are audited too
+                    *event = new CAudited_Event(clone, m_audit);
+                }
+                return result;
+            }
+        };
+    }
+
+    std::uint64_t TEvent_Audit::getAlive() const {
+        const std::uint64_t releasedEvents = released.load();
+        const std::uint64_t createdEvents = created.load();
+        return createdEvents > releasedEvents ? createdEvents - releasedEvents : 0;
+    }
+
+    EventAuditor::EventAuditor() : m_enabled(false) {
+        //
+    }
+
+    EventAuditor& EventAuditor::getInstance() {
+        static EventAuditor instance;
+        return instance;
+    }
+
+    void EventAuditor::enable() {
+        m_enabled = true;
+    }
+
+    bool EventAuditor::isEnabled() const {
+        return m_enabled;
+    }
+
+    std::shared_ptr<TEvent_Audit> EventAuditor::beginScope() {
+        t_scope = std::make_shared<TEvent_Audit>();
+        return t_scope;
+    }
+
+    void EventAuditor::endScope() {
+        t_scope.reset();
+    }
+
+    scgms::IDevice_Event* EventAuditor::track(scgms::IDevice_Event* event) {
+        if (event == nullptr || !m_enabled || !t_scope) {
+            return event;
+        }
+
+        return new CAudited_Event(event, t_scope);
+    }
+
+    void EventAuditor::record(const std::wstring& filter, const std::wstring& test, const TEvent_Audit& audit) {
+        const std::uint64_t alive = audit.getAlive();
+        if (alive > 0) {
+            Logger::getInstance().warn(std::to_wstring(alive) + L" of " + std::to_wstring(audit.created.load())
+                                       + L" events created by " + test + L" are still alive after the test ended!");
+        } else {
+            Logger::getInstance().debug(L"All " + std::to_wstring(audit.created.load()) + L" events created by "
+                                        + test + L" were released.");
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TFilter_Audit& filterAudit = m_filters[filter];
+        filterAudit.created += audit.created.load();
+        filterAudit.released += audit.released.load();
+        if (alive > 0) {
+            filterAudit.leakingTests.emplace_back(test, alive);
+        }
+    }
+
+    bool EventAuditor::printSummary(std::wostream& output) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        output << L"Event audit:\n"
+               << std::left << std::setw(34) << L"filter" << std::right << std::setw(12) << L"created"
+               << std::setw(12) << L"released" << std::setw(12) << L"alive" << L"\n";
+
+        bool clean = true;
+        for (const auto& filter : m_filters) {
+            const TFilter_Audit& audit = filter.second;
+            const std::uint64_t alive = audit.created > audit.released ? audit.created - audit.released : 0;
+            output << std::left << std::setw(34) << filter.first << std::right << std::setw(12) << audit.created
+                   << std::setw(12) << audit.released << std::setw(12) << alive << L"\n";
+            for (const auto& test : audit.leakingTests) {
+                output << L"    " << test.first << L": " << test.second << L" events still alive\n";
+            }
+
+            Logger::getInstance().info(L"Event audit of " + filter.first + L": " + std::to_wstring(audit.created)
+                                       + L" created, " + std::to_wstring(audit.released) + L" released, "
+                                       + std::to_wstring(alive) + L" alive");
+            if (alive > 0) {
+                clean = false;
+            }
+        }
+
+        return clean;
+    }
+}
@@ -0,0 +1,255 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <cmath>
+#include <cctype>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <rtl/referencedImpl.h>
+#include <utils/string_utils.h>
+#include "../EventGenerator.h"
+#include "../scgmsLibUtils.h"
+
+namespace {
+    /// Levels of the random walk are kept in a physiologically plausible range, in mmol/l
+    constexpr double MIN_LEVEL = 2.0;
+    constexpr double MAX_LEVEL = 25.0;
+    /// Level the random walk is pulled back to and the strength of the pull per event
+    constexpr double MEAN_LEVEL = 7.0;
+    constexpr double MEAN_REVERSION = 0.01;
+    /// Standard deviation of a single step of the random walk
+    constexpr double LEVEL_STEP_DEVIATION = 0.1;
+    constexpr double PI = 3.14159265358979323846;
+
+    /// Returns cumulative weights of given weighted items
+    template<typename T>
+    std::vector<double> cumulativeWeightsOf(const std::vector<std::pair<T, double>>& items) {
+        std::vector<double> weights;
+        for (const auto& item : items) {
+            weights.push_back(item.second);
+        }
+        std::partial_sum(weights.begin(), weights.end(), weights.begin());
+        return weights;
+    }
+
+    std::string toLower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+        return text;
+    }
+
+    /**
+     * Splits specification "<name>:<weight>,..." into names and weights.
+     * @throws std::invalid_argument if an item is missing its weight or the weight isn't positive
+     */
+    std::vector<std::pair<std::string, double>> parseWeighted(const std::string& specification) {
+        std::vector<std::pair<std::string, double>> items;
+        std::size_t begin = 0;
+        while (begin <= specification.size()) {
+            std::size_t end = specification.find(',', begin);
+            if (end == std::string::npos) {
+                end = specification.size();
+            }
+
+            const std::string item = specification.substr(begin, end - begin);
+            const std::size_t separator = item.rfind(':');
+            if (separator == std::string::npos || separator == 0) {
+                throw std::invalid_argument("Missing weight of " + item);
+            }
+
+            const double weight = std::stod(item.substr(separator + 1));
+            if (!(weight > 0.0)) {
+                throw std::invalid_argument("Weight has to be positive");
+            }
+            items.emplace_back(item.substr(0, separator), weight);
+            begin = end + 1;
+        }
+
+        return items;
+    }
+}
+
+EventGenerator::EventGenerator(TGenerator_Config config)
+        : m_config(std::move(config)), m_randomState(m_config.seed),
+          m_codeWeights(cumulativeWeightsOf(m_config.eventCodes)),
+          m_signalWeights(cumulativeWeightsOf(m_config.signals)),
+          m_deviceTime(m_config.startTime) {
+    //
+}
+
+double EventGenerator::nextUniform() {
+    std::uint64_t z = (m_randomState += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    return static_cast<double>(z >> 11) * 0x1.0p-53;
+}
+
+std::size_t EventGenerator::nextIndex(const std::vector<double>& cumulativeWeights) {
+    const double drawn = nextUniform() * cumulativeWeights.back();
+    const auto index = std::upper_bound(cumulativeWeights.begin(), cumulativeWeights.end(), drawn) - cumulativeWeights.begin();
+    return std::min(static_cast<std::size_t>(index), cumulativeWeights.size() - 1);
+}
+
+scgms::IDevice_Event* EventGenerator::next() {
+    if (m_config.segmentLength > 0) {
+        if (!m_segmentOpen) {
+            m_segmentId++;
+            m_segmentEvents = 0;
+            m_segmentOpen = true;
+            return createNext(scgms::NDevice_Event_Code::Time_Segment_Start);
+        }
+
+        if (m_segmentEvents == m_config.segmentLength) {
+            m_segmentOpen = false;
+            return createNext(scgms::NDevice_Event_Code::Time_Segment_Stop);
+        }
+        m_segmentEvents++;
+    }
+
+    if (m_config.eventCodes.empty()) {
+        return createNext(scgms::NDevice_Event_Code::Level);
+    }
+    return createNext(m_config.eventCodes[nextIndex(m_codeWeights)].first);
+}
+
+scgms::IDevice_Event* EventGenerator::createNext(const scgms::NDevice_Event_Code eventCode) {
+    scgms::IDevice_Event* event = createEvent(eventCode);
+    if (event == nullptr) {
+        return nullptr;
+    }
+
+    scgms::TDevice_Event* raw_event;
+    event->Raw(&raw_event);
+    raw_event->device_time = m_deviceTime;
+    raw_event->segment_id = m_segmentId;
+
+    switch (eventCode) {
+        case scgms::NDevice_Event_Code::Time_Segment_Start:
+        case scgms::NDevice_Event_Code::Time_Segment_Stop:
+            return event;   /// Segment boundaries don't advance the time and carry no signal
+        case scgms::NDevice_Event_Code::Level:
+        case scgms::NDevice_Event_Code::Masked_Level: {
+            /// Box-Muller transform of two uniform numbers into a normally distributed step
+            const double step = LEVEL_STEP_DEVIATION * std::sqrt(-2.0 * std::log(1.0 - nextUniform()))
+                                * std::cos(2.0 * PI * nextUniform());
+            m_level = std::clamp(m_level + MEAN_REVERSION * (MEAN_LEVEL - m_level) + step, MIN_LEVEL, MAX_LEVEL);
+            raw_event->level = m_level;
+            break;
+        }
+        case scgms::NDevice_Event_Code::Parameters: {
+            std::vector<double> values(m_config.parameterCount);
+            for (double& value : values) {
+                value = nextUniform();
+            }
+            raw_event->parameters = refcnt::Create_Container<double>(values.data(), values.data() + values.size());
+            break;
+        }
+        case scgms::NDevice_Event_Code::Information:
+            raw_event->info = refcnt::WString_To_WChar_Container(L"Generated event");
+            break;
+        default:
+            break;
+    }
+
+    if (!m_config.signals.empty()) {
+        raw_event->signal_id = m_config.signals[nextIndex(m_signalWeights)].first;
+    }
+    m_deviceTime += m_config.timeStep;
+    return event;
+}
+
+std::vector<scgms::IDevice_Event*> EventGenerator::generate(const std::size_t count) {
+    std::vector<scgms::IDevice_Event*> events;
+    events.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        scgms::IDevice_Event* event = next();
+        if (event == nullptr) {
+            releaseEvents(events);
+            return events;
+        }
+        events.push_back(event);
+    }
+
+    return events;
+}
+
+HRESULT EventGenerator::drive(scgms::IFilter* filter, const std::size_t count, std::size_t& rejected) {
+    for (std::size_t i = 0; i < count; i++) {
+        scgms::IDevice_Event* event = next();
+        if (event == nullptr) {
+            return E_FAIL;
+        }
+
+        if (!Succeeded(filter->Execute(event))) {
+            event->Release();   /// Not consumed by the filter
+            rejected++;
+        }
+    }
+
+    return S_OK;
+}
+
+std::uint64_t EventGenerator::getSegmentId() const {
+    return m_segmentId;
+}
+
+std::vector<std::pair<GUID, double>> EventGenerator::parseSignals(const std::string& specification) {
+    static const std::vector<std::pair<std::string, GUID>> SIGNAL_NAMES = {
+            { "bg", scgms::signal_BG },
+            { "ig", scgms::signal_IG },
+            { "isig", scgms::signal_ISIG },
+            { "cob", scgms::signal_COB },
+            { "iob", scgms::signal_IOB },
+            { "calibration", scgms::signal_Calibration },
+            { "carb_intake", scgms::signal_Carb_Intake }
+    };
+
+    std::vector<std::pair<GUID, double>> signals;
+    for (const auto& item : parseWeighted(specification)) {
+        const std::string name = toLower(item.first);
+        auto known = std::find_if(SIGNAL_NAMES.begin(), SIGNAL_NAMES.end(), [&name](const auto& signal) {
+            return signal.first == name;
+        });
+
+        if (known != SIGNAL_NAMES.end()) {
+            signals.emplace_back(known->second, item.second);
+            continue;
+        }
+
+        bool ok = false;
+        const GUID signalId = WString_To_GUID(Widen_String(item.first), ok);
+        if (!ok) {
+            throw std::invalid_argument("Unknown signal " + item.first);
+        }
+        signals.emplace_back(signalId, item.second);
+    }
+
+    return signals;
+}
+
+std::vector<std::pair<scgms::NDevice_Event_Code, double>> EventGenerator::parseEventCodes(const std::string& specification) {
+    static const std::vector<std::pair<std::string, scgms::NDevice_Event_Code>> CODE_NAMES = {
+            { "level", scgms::NDevice_Event_Code::Level },
+            { "masked", scgms::NDevice_Event_Code::Masked_Level },
+            { "parameters", scgms::NDevice_Event_Code::Parameters },
+            { "information", scgms::NDevice_Event_Code::Information }
+    };
+
+    std::vector<std::pair<scgms::NDevice_Event_Code, double>> eventCodes;
+    for (const auto& item : parseWeighted(specification)) {
+        const std::string name = toLower(item.first);
+        auto known = std::find_if(CODE_NAMES.begin(), CODE_NAMES.end(), [&name](const auto& code) {
+            return code.first == name;
+        });
+
+        if (known == CODE_NAMES.end()) {
+            throw std::invalid_argument("Unknown event code " + item.first);
+        }
+        eventCodes.emplace_back(known->second, item.second);
+    }
+
+    return eventCodes;
+}
@@ -0,0 +1,51 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <iostream>
+#include "../FilterLibraryCache.h"
+#include "../../mappers/GuidFileMapper.h"
+#include "../constants.h"
+#include "../Logger.h"
+
+FilterLibraryCache& FilterLibraryCache::getInstance() {
+    static FilterLibraryCache instance;
+    return instance;
+}
+
+std::shared_ptr<TFilter_Library> FilterLibraryCache::getLibrary(const std::wstring& fileName) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto cached = m_libraries.find(fileName);
+    if (cached != m_libraries.end()) {
+        return cached->second;
+    }
+
+    auto library = std::make_shared<TFilter_Library>();
+    library->library.Load(fileName);
+    if (!library->library.Is_Loaded()) {
+        Logger::getInstance().error(L"Couldn't load " + fileName + L" library.");
+        return nullptr;     /// Not caching the failure, the library may appear later
+    }
+
+    library->createFilter = library->library.Resolve<scgms::TCreate_Filter>("do_create_filter");
+    library->getFilterDescriptors = library->library.Resolve<scgms::TGet_Filter_Descriptors>("do_get_filter_descriptors");
+    if (library->createFilter == nullptr || library->getFilterDescriptors == nullptr) {
+        Logger::getInstance().error(L"Library " + fileName + L" does not export filter entry points!");
+        return nullptr;
+    }
+
+    Logger::getInstance().info(L"Library " + fileName + L" loaded.");
+    m_libraries[fileName] = library;
+    return library;
+}
+
+std::shared_ptr<TFilter_Library> FilterLibraryCache::getFilterLibrary(const GUID& filterGuid) {
+    const wchar_t* fileName = GuidFileMapper::GetInstance().getFileName(filterGuid);
+    if (fileName == nullptr) {
+        Logger::getInstance().error(L"No library is mapped to filter " + GUID_To_WString(filterGuid) + L"!");
+        return nullptr;
+    }
+
+    return getLibrary(std::wstring(fileName) + cnst::LIB_EXTENSION);
+}
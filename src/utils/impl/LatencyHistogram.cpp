@@ -0,0 +1,101 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "../LatencyHistogram.h"
+
+namespace tester {
+
+    LatencyHistogram::LatencyHistogram() {
+        reset();
+    }
+
+    std::size_t LatencyHistogram::bucketIndex(const std::uint64_t value) {
+        unsigned int highestBit = 0;
+        for (std::uint64_t rest = value; rest > 1; rest >>= 1) {
+            highestBit++;
+        }
+
+        /// Shift keeps the SUB_BUCKET_BITS + 1 highest bits of the value, so sub-bucket is in upper half of the range
+        const unsigned int shift = highestBit > SUB_BUCKET_BITS ? highestBit - SUB_BUCKET_BITS : 0;
+        return shift * SUB_BUCKET_COUNT + static_cast<std::size_t>(value >> shift);
+    }
+
+    std::uint64_t LatencyHistogram::bucketHighestValue(const std::size_t index) {
+        if (index < 2 * SUB_BUCKET_COUNT) {
+            return index;
+        }
+
+        const std::size_t shift = index / SUB_BUCKET_COUNT - 1;
+        const std::uint64_t subBucket = index - shift * SUB_BUCKET_COUNT;
+        return ((subBucket + 1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(const std::uint64_t value) {
+        m_counts[bucketIndex(value)]++;
+        m_count++;
+        m_total += value;
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_count += other.m_count;
+        m_total += other.m_total;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+    }
+
+    void LatencyHistogram::reset() {
+        m_counts.fill(0);
+        m_count = 0;
+        m_total = 0;
+        m_min = std::numeric_limits<std::uint64_t>::max();
+        m_max = 0;
+    }
+
+    std::uint64_t LatencyHistogram::getCount() const {
+        return m_count;
+    }
+
+    std::uint64_t LatencyHistogram::getTotal() const {
+        return m_total;
+    }
+
+    double LatencyHistogram::getMean() const {
+        return m_count == 0 ? 0.0 : static_cast<double>(m_total) / m_count;
+    }
+
+    std::uint64_t LatencyHistogram::getMin() const {
+        return m_count == 0 ? 0 : m_min;
+    }
+
+    std::uint64_t LatencyHistogram::getMax() const {
+        return m_max;
+    }
+
+    std::uint64_t LatencyHistogram::getPercentile(const double percentile) const {
+        if (m_count == 0) {
+            return 0;
+        }
+
+        const double clamped = std::clamp(percentile, 0.0, 100.0);
+        const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * m_count)));
+
+        std::uint64_t counted = 0;
+        for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+            counted += m_counts[i];
+            if (counted >= rank) {
+                return std::min(bucketHighestValue(i), m_max);
+            }
+        }
+
+        return m_max;
+    }
+}
@@ -0,0 +1,362 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <cctype>
+#include <charconv>
+#include <system_error>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+#include "../LogColumns.h"
+#include "../constants.h"
+
+namespace tester {
+
+    static_assert(NLog_Column::Info == cnst::firstNumberValueIndex && NLog_Column::Event_Code_Id == cnst::lastNumberValueIndex,
+                  "Numeric columns must match the compared numeric values");
+
+    namespace {
+        /// Parses a signed integer the way std::stoll would, ignoring anything following the number
+        std::int64_t parseInteger(const std::string_view field) {
+            std::size_t i = 0;
+            while (i < field.size() && std::isspace(static_cast<unsigned char>(field[i]))) {
+                i++;
+            }
+            const bool negative = i < field.size() && field[i] == '-';
+            if (i < field.size() && (field[i] == '-' || field[i] == '+')) {
+                i++;
+            }
+
+            std::int64_t value = 0;
+            for (; i < field.size() && field[i] >= '0' && field[i] <= '9'; i++) {
+                value = value * 10 + (field[i] - '0');
+            }
+            return negative ? -value : value;
+        }
+
+        /// Parses exactly given number of digits at given position, returns false if some of them isn't a digit
+        bool parseDigits(const std::string_view field, const std::size_t position, const std::size_t count, int& value) {
+            if (position + count > field.size()) {
+                return false;
+            }
+
+            value = 0;
+            for (std::size_t i = position; i < position + count; i++) {
+                if (field[i] < '0' || field[i] > '9') {
+                    return false;
+                }
+                value = value * 10 + (field[i] - '0');
+            }
+            return true;
+        }
+
+        /// Returns number of days between 1970-01-01 and given date of the proleptic Gregorian calendar
+        std::int64_t daysFromCivil(int year, const int month, const int day) {
+            year -= month <= 2;
+            const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+            const auto yearOfEra = static_cast<std::int64_t>(year - era * 400);
+            const std::int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+            const std::int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+            return era * 146097 + dayOfEra - 719468;
+        }
+
+        /**
+         * Parses device time in the "YYYY-MM-DD HH:MM:SS" format, optionally followed by a fraction of seconds.
+         * @return seconds since 1970-01-01, NaN if the time isn't in the expected format
+         */
+        double parseDeviceTime(const std::string_view field) {
+            constexpr std::size_t TIME_LENGTH = 19;
+            int year, month, day, hours, minutes, seconds;
+            if (field.size() < TIME_LENGTH || !parseDigits(field, 0, 4, year) || field[4] != '-'
+                || !parseDigits(field, 5, 2, month) || field[7] != '-' || !parseDigits(field, 8, 2, day) || field[10] != ' ' || !parseDigits(field, 11, 2, hours)
+                || field[13] != ':' || !parseDigits(field, 14, 2, minutes) || field[16] != ':'
+                || !parseDigits(field, 17, 2, seconds)) {
+                return std::numeric_limits<double>::quiet_NaN();
+            }
+
+            double time = static_cast<double>(daysFromCivil(year, month, day) * 86400 + hours * 3600 + minutes * 60 + seconds);
+            if (field.size() > TIME_LENGTH + 1 && field[TIME_LENGTH] == '.') {
+                double unit = 0.1;
+                for (std::size_t i = TIME_LENGTH + 1; i < field.size() && field[i] >= '0' && field[i] <= '9'; i++, unit /= 10.0) {
+                    time += (field[i] - '0') * unit;
+                }
+            }
+            return time;
+        }
+
+        /// Parses given number by std::strtod, returns false if the field doesn't start with a number
+        bool parseByStrtod(const std::string_view field, double& value) {
+            /// Tokens aren't terminated, numbers are short enough to be copied to the stack
+            char buffer[64];
+            std::string copy;
+            const char* begin = buffer;
+            if (field.size() < sizeof(buffer)) {
+                std::memcpy(buffer, field.data(), field.size());
+                buffer[field.size()] = '\0';
+            } else {
+                copy.assign(field);
+                begin = copy.c_str();
+            }
+
+            char* end;
+            value = std::strtod(begin, &end);
+            return end != begin;
+        }
+
+        /**
+         * Parses a number the way std::stod would, ignoring anything following the number.
+         * std::from_chars doesn't depend on the locale and doesn't need the token terminated, only the leading
+         * white space and plus sign it doesn't accept are skipped first. Hexadecimal and out of range numbers
+         * are left to std::strtod, as well as everything if the standard library lacks floating point from_chars.
+         * @return false if the field doesn't start with a number
+         */
+        bool parseNumber(const std::string_view field, double& value) {
+#if defined(__cpp_lib_to_chars)
+            std::size_t i = 0;
+            while (i < field.size() && std::isspace(static_cast<unsigned char>(field[i]))) {
+                i++;
+            }
+            if (i < field.size() && field[i] == '+') {
+                if (i + 1 < field.size() && field[i + 1] == '-') {
+                    return false;
+                }
+                i++;
+            }
+
+            const char* end = field.data() + field.size();
+            const std::from_chars_result parsed = std::from_chars(field.data() + i, end, value);
+            if (parsed.ec == std::errc::invalid_argument) {
+                return false;
+            }
+            if (parsed.ec == std::errc() && (parsed.ptr == end || (*parsed.ptr != 'x' && *parsed.ptr != 'X'))) {
+                return true;
+            }
+#endif
+            return parseByStrtod(field, value);
+        }
+
+        /// Parses value of a numeric column and appends it to the column, values which aren't numbers are kept as texts
+        void appendNumber(TLog_Numbers& column, const std::string_view field, LogDictionary& dictionary) {
+            double value = 0.0;
+            NLog_Value kind = NLog_Value::Empty;
+            std::uint32_t text = LogDictionary::EMPTY;
+            if (!field.empty()) {
+                if (parseNumber(field, value)) {
+                    kind = NLog_Value::Number;
+                } else {
+                    value = 0.0;
+                    kind = NLog_Value::Text;
+                    text = dictionary.intern(field);
+                }
+            }
+
+            column.values.push_back(value);
+            column.kinds.push_back(kind);
+            column.texts.push_back(text);
+        }
+
+        template <typename T>
+        void permuteColumn(std::vector<T>& column, const std::vector<std::size_t>& order) {
+            std::vector<T> permuted;
+            permuted.reserve(column.size());
+            for (std::size_t row : order) {
+                permuted.push_back(column[row]);
+            }
+            column = std::move(permuted);
+        }
+
+        template <typename T>
+        void appendColumn(std::vector<T>& column, const std::vector<T>& other) {
+            column.insert(column.end(), other.begin(), other.end());
+        }
+
+        /// Appends dictionary ids translated into the ids of the merged dictionary
+        void appendIds(std::vector<std::uint32_t>& column, const std::vector<std::uint32_t>& other, const std::vector<std::uint32_t>& ids) {
+            column.reserve(column.size() + other.size());
+            for (std::uint32_t id : other) {
+                column.push_back(ids[id]);
+            }
+        }
+    }
+
+    LogDictionary::LogDictionary() {
+        intern(std::string_view());
+    }
+
+    std::uint32_t LogDictionary::intern(const std::string_view text) {
+        auto inserted = m_ids.emplace(text, static_cast<std::uint32_t>(m_texts.size()));
+        if (inserted.second) {
+            m_texts.push_back(text);
+        }
+        return inserted.first->second;
+    }
+
+    std::string_view LogDictionary::getText(const std::uint32_t id) const {
+        return m_texts.at(id);
+    }
+
+    std::uint32_t LogDictionary::find(const std::string_view text) const {
+        auto id = m_ids.find(text);
+        return id == m_ids.end() ? NOT_FOUND : id->second;
+    }
+
+    std::size_t LogDictionary::size() const {
+        return m_texts.size();
+    }
+
+    std::vector<std::uint32_t> LogDictionary::merge(const LogDictionary& other) {
+        std::lock_guard<std::mutex> lock(m_mergeMutex);
+        std::vector<std::uint32_t> ids;
+        ids.reserve(other.m_texts.size());
+        for (const std::string_view text : other.m_texts) {
+            ids.push_back(intern(text));
+        }
+        return ids;
+    }
+
+    std::size_t TLog_Columns::size() const {
+        return lines.size();
+    }
+
+    void TLog_Columns::permute(const std::vector<std::size_t>& order) {
+        permuteColumn(lines, order);
+        permuteColumn(widths, order);
+        permuteColumn(logicalClock, order);
+        permuteColumn(deviceTime, order);
+        permuteColumn(eventCode, order);
+        permuteColumn(signal, order);
+        permuteColumn(deviceId, order);
+        permuteColumn(rest, order);
+        for (auto& column : numbers) {
+            permuteColumn(column.values, order);
+            permuteColumn(column.kinds, order);
+            permuteColumn(column.texts, order);
+        }
+    }
+
+    void TLog_Columns::append(const TLog_Columns& other, const std::vector<std::uint32_t>& ids) {
+        appendColumn(lines, other.lines);
+        appendColumn(widths, other.widths);
+        appendColumn(logicalClock, other.logicalClock);
+        appendColumn(deviceTime, other.deviceTime);
+        appendIds(eventCode, other.eventCode, ids);
+        appendIds(signal, other.signal, ids);
+        appendIds(deviceId, other.deviceId, ids);
+        appendIds(rest, other.rest, ids);
+        for (std::size_t i = 0; i < std::size(numbers); i++) {
+            appendColumn(numbers[i].values, other.numbers[i].values);
+            appendColumn(numbers[i].kinds, other.numbers[i].kinds);
+            appendIds(numbers[i].texts, other.numbers[i].texts, ids);
+        }
+    }
+
+    LogColumns::LogColumns(const std::string& logPath, LogDictionary& dictionary, std::size_t threads)
+            : m_reader(logPath), m_dictionary(dictionary) {
+        std::string_view text = m_reader.getText();
+        if (text.empty()) {
+            return;
+        }
+
+        const std::size_t headerEnd = text.find('\n');
+        LogReader::tokenize(text.substr(0, headerEnd), m_header);
+        m_empty = false;
+        if (headerEnd == std::string_view::npos) {
+            return;
+        }
+        text.remove_prefix(headerEnd + 1);
+
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        const std::vector<std::string_view> chunks = LogReader::splitLines(text, std::min(threads, text.size() / MIN_CHUNK_SIZE + 1));
+
+        /// Chunks are parsed with their own dictionaries, the first one by this thread
+        std::vector<TLog_Columns> chunkColumns(chunks.size());
+        std::vector<LogDictionary> chunkDictionaries(chunks.size());
+        auto parseChunk = [&](const std::size_t chunk) {
+            LogReader::forEachLine(chunks[chunk], [&](std::string_view line, const TLog_Line& tokens) {
+                appendRow(chunkColumns[chunk], chunkDictionaries[chunk], line, tokens);
+            });
+        };
+
+        std::vector<std::thread> workers;
+        for (std::size_t chunk = 1; chunk < chunks.size(); chunk++) {
+            workers.emplace_back(parseChunk, chunk);
+        }
+        if (!chunks.empty()) {
+            parseChunk(0);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        std::size_t rows = 0;
+        for (const auto& columns : chunkColumns) {
+            rows += columns.size();
+        }
+        m_columns.lines.reserve(rows);
+        for (std::size_t chunk = 0; chunk < chunks.size(); chunk++) {
+            m_columns.append(chunkColumns[chunk], m_dictionary.merge(chunkDictionaries[chunk]));
+            chunkColumns[chunk] = TLog_Columns();   /// Releasing the chunk right away keeps the peak memory lower
+        }
+    }
+
+    void LogColumns::appendRow(TLog_Columns& columns, LogDictionary& dictionary, const std::string_view line, const TLog_Line& tokens) {
+        /// Missing columns are empty, they are never compared with present ones because the widths differ
+        auto token = [&tokens](const std::size_t column) {
+            return column < tokens.size() ? tokens[column] : std::string_view();
+        };
+
+        columns.lines.push_back(line);
+        columns.widths.push_back(static_cast<std::uint16_t>(std::min<std::size_t>(tokens.size(), UINT16_MAX)));
+        columns.logicalClock.push_back(parseInteger(token(NLog_Column::Logical_Clock)));
+        columns.deviceTime.push_back(parseDeviceTime(token(NLog_Column::Device_Time)));
+        columns.eventCode.push_back(dictionary.intern(token(NLog_Column::Event_Code)));
+        columns.signal.push_back(dictionary.intern(token(NLog_Column::Signal)));
+        for (std::size_t column = NLog_Column::Info; column < NLog_Column::Device_Id; column++) {
+            appendNumber(columns.numbers[column - NLog_Column::Info], token(column), dictionary);
+        }
+        columns.deviceId.push_back(dictionary.intern(token(NLog_Column::Device_Id)));
+
+        /// Tokens are views into one line, so all the remaining ones are covered by a single view
+        std::string_view rest;
+        if (tokens.size() > NLog_Column::Rest) {
+            const char* begin = tokens[NLog_Column::Rest].data();
+            rest = std::string_view(begin, static_cast<std::size_t>(tokens.back().data() + tokens.back().size() - begin));
+        }
+        columns.rest.push_back(dictionary.intern(rest));
+    }
+
+    bool LogColumns::isEmpty() const {
+        return m_empty;
+    }
+
+    const TLog_Line& LogColumns::getHeader() const {
+        return m_header;
+    }
+
+    const TLog_Columns& LogColumns::getColumns() const {
+        return m_columns;
+    }
+
+    TLog_Line LogColumns::getRow(const std::size_t row) const {
+        TLog_Line tokens;
+        LogReader::tokenize(m_columns.lines.at(row), tokens);
+        return tokens;
+    }
+
+    void LogColumns::sortByLogicalClock() {
+        std::vector<std::size_t> order(m_columns.size());
+        for (std::size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [this](const std::size_t first, const std::size_t second) {
+            return m_columns.logicalClock[first] < m_columns.logicalClock[second];
+        });
+        m_columns.permute(order);
+    }
+}
@@ -0,0 +1,270 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <cmath>
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include "../LogComparator.h"
+
+namespace tester {
+
+    namespace {
+        constexpr std::uint64_t HASH_SEED = 14695981039346656037ull;
+        constexpr std::uint64_t HASH_MULTIPLIER = 0x9E3779B97F4A7C15ull;
+        constexpr std::size_t NUMERIC_COLUMNS = ComparisonSchema::NUMERIC_COLUMNS;
+        /// Cells are wider than the tolerance, so most values are far enough from the edges of their cells
+        /// to be looked for only in the one cell
+        constexpr double CELLS_PER_TOLERANCE = 16.0;
+        /// Width of the cells of columns compared exactly, which still have to be quantized
+        constexpr double MIN_CELL_WIDTH = 1.0e-12;
+        /// Quantized values are clamped, so they fit into the cell index
+        constexpr double MAX_CELL = 9.0e18;
+
+        /// Compared columns of a row, reduced for hashing
+        struct TRow_Key {
+            /// Hash of the row width and all compared columns except the numeric values
+            std::uint64_t hash = HASH_SEED;
+            /// Cells of the numeric values, valid where the column holds a number and is hashed
+            std::int64_t cells[NUMERIC_COLUMNS] = {};
+            /// Offsets of the neighbouring cells, which may contain a value within the tolerance
+            int lowestOffset[NUMERIC_COLUMNS] = {};
+            int highestOffset[NUMERIC_COLUMNS] = {};
+            bool isNumber[NUMERIC_COLUMNS] = {};
+        };
+
+        /// Mixes given value into the hash, a word at a time
+        void mix(std::uint64_t& hash, const std::uint64_t value) {
+            hash ^= value;
+            hash *= HASH_MULTIPLIER;
+            hash ^= hash >> 32;
+        }
+
+        /// Returns position of given value in cell widths, shifted by half a cell, so integers lie in the middle of the cells
+        double scale(const double value, const double cellWidth) {
+            return std::max(-MAX_CELL, std::min(MAX_CELL, value / cellWidth + 0.5));
+        }
+
+        /**
+         * Reduces compared columns of given row into a key.
+         * @param cellWidths widths of the cells of the numeric columns, 0 if only the kind of the value is hashed
+         * @param neighbourDistances distances from the edges of the cells, in cell widths, within which the neighbouring
+         * cells are looked into too, slightly wider than the tolerance to cover rounding
+         */
+        TRow_Key makeKey(const TLog_Columns& columns, const std::size_t row, const double (&cellWidths)[NUMERIC_COLUMNS],
+                         const double (&neighbourDistances)[NUMERIC_COLUMNS]) {
+            TRow_Key key;
+            mix(key.hash, columns.widths[row]);
+            mix(key.hash, columns.eventCode[row]);
+            mix(key.hash, columns.signal[row]);
+            mix(key.hash, columns.deviceId[row]);
+            mix(key.hash, columns.rest[row]);
+            for (std::size_t slot = 0; slot < NUMERIC_COLUMNS; slot++) {
+                const TLog_Numbers& numbers = columns.numbers[slot];
+                mix(key.hash, static_cast<std::uint64_t>(numbers.kinds[row]));
+                if (numbers.kinds[row] == NLog_Value::Number) {
+                    if (cellWidths[slot] > 0.0) {
+                        const double position = scale(numbers.values[row], cellWidths[slot]);
+                        const double cell = std::floor(position);
+                        key.cells[slot] = static_cast<std::int64_t>(cell);
+                        key.isNumber[slot] = true;
+                        key.lowestOffset[slot] = position - cell < neighbourDistances[slot] ? -1 : 0;
+                        key.highestOffset[slot] = cell + 1.0 - position < neighbourDistances[slot] ? 1 : 0;
+                    }
+                } else {
+                    mix(key.hash, numbers.texts[row]);
+                }
+            }
+            return key;
+        }
+
+        /// Returns hash of the key with every numeric cell moved by given offset
+        std::uint64_t hashOf(const TRow_Key& key, const int (&offsets)[NUMERIC_COLUMNS]) {
+            std::uint64_t hash = key.hash;
+            for (std::size_t slot = 0; slot < NUMERIC_COLUMNS; slot++) {
+                if (key.isNumber[slot]) {
+                    mix(hash, static_cast<std::uint64_t>(key.cells[slot] + offsets[slot]));
+                }
+            }
+            return hash;
+        }
+    }
+
+    LogComparator::LogComparator(const ComparisonSchema& schema, const LogDictionary& dictionary) {
+        for (std::size_t slot = 0; slot < NUMERIC_COLUMNS; slot++) {
+            m_tolerances[slot] = schema.getTolerance(slot);
+            bool absolute = m_tolerances[slot].kind == NTolerance_Kind::Absolute;
+            double widest = m_tolerances[slot].value;
+            for (const auto& signal : schema.getSignalTolerances(slot)) {
+                const std::uint32_t id = dictionary.find(signal.first);
+                if (id == LogDictionary::NOT_FOUND) {       /// The signal isn't in the compared logs
+                    continue;
+                }
+                if (m_signalTolerances[slot].empty()) {
+                    m_signalTolerances[slot].assign(dictionary.size(), m_tolerances[slot]);
+                }
+                m_signalTolerances[slot][id] = signal.second;
+                absolute = absolute && signal.second.kind == NTolerance_Kind::Absolute;
+                widest = std::max(widest, signal.second.value);
+            }
+
+            /// Values within a relative or ULP tolerance may lie arbitrarily far apart, so they can't be quantized
+            const double cellWidth = CELLS_PER_TOLERANCE * widest;
+            m_cellWidths[slot] = absolute && std::isfinite(cellWidth) ? std::max(cellWidth, MIN_CELL_WIDTH) : 0.0;
+        }
+    }
+
+    const TTolerance& LogComparator::getTolerance(const std::size_t slot, const std::uint32_t signal) const {
+        return m_signalTolerances[slot].empty() ? m_tolerances[slot] : m_signalTolerances[slot][signal];
+    }
+
+    bool LogComparator::rowsMatch(const TLog_Columns& result, const std::size_t resultRow,
+                                  const TLog_Columns& reference, const std::size_t referenceRow) const {
+        if (result.widths[resultRow] != reference.widths[referenceRow]
+            || result.eventCode[resultRow] != reference.eventCode[referenceRow]
+            || result.signal[resultRow] != reference.signal[referenceRow]
+            || result.deviceId[resultRow] != reference.deviceId[referenceRow]
+            || result.rest[resultRow] != reference.rest[referenceRow]) {
+            return false;
+        }
+
+        for (std::size_t slot = 0; slot < NUMERIC_COLUMNS; slot++) {
+            const TLog_Numbers& actual = result.numbers[slot];
+            const TLog_Numbers& expected = reference.numbers[slot];
+            if (actual.kinds[resultRow] != expected.kinds[referenceRow]
+                || actual.texts[resultRow] != expected.texts[referenceRow]
+                || !getTolerance(slot, reference.signal[referenceRow]).accepts(expected.values[referenceRow], actual.values[resultRow])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool LogComparator::matchesAligned(const TLog_Columns& result, const TLog_Columns& reference) const {
+        const std::size_t rows = result.size();
+        if (rows != reference.size()) {
+            return false;
+        }
+
+        /// Mismatches are counted instead of stopping at the first one, so the loops don't branch and are vectorized
+        std::size_t mismatches = 0;
+        for (std::size_t i = 0; i < rows; i++) {
+            mismatches += (result.widths[i] != reference.widths[i]) | (result.eventCode[i] != reference.eventCode[i])
+                          | (result.signal[i] != reference.signal[i]) | (result.deviceId[i] != reference.deviceId[i])
+                          | (result.rest[i] != reference.rest[i]);
+        }
+
+        for (std::size_t slot = 0; slot < NUMERIC_COLUMNS && mismatches == 0; slot++) {
+            const TLog_Numbers& actual = result.numbers[slot];
+            const TLog_Numbers& expected = reference.numbers[slot];
+            for (std::size_t i = 0; i < rows; i++) {
+                mismatches += (actual.kinds[i] != expected.kinds[i]) | (actual.texts[i] != expected.texts[i]);
+            }
+
+            /// Values which aren't numbers are 0, so they're within any tolerance
+            const double* actualValues = actual.values.data();
+            const double* expectedValues = expected.values.data();
+            const double tolerance = m_tolerances[slot].value;
+            if (!m_signalTolerances[slot].empty() || m_tolerances[slot].kind == NTolerance_Kind::Ulp) {
+                for (std::size_t i = 0; i < rows; i++) {
+                    mismatches += !getTolerance(slot, reference.signal[i]).accepts(expectedValues[i], actualValues[i]);
+                }
+            } else if (m_tolerances[slot].kind == NTolerance_Kind::Relative) {
+                for (std::size_t i = 0; i < rows; i++) {
+                    mismatches += std::fabs(actualValues[i] - expectedValues[i])
+                                  > tolerance * std::max(std::fabs(expectedValues[i]), std::fabs(actualValues[i]));
+                }
+            } else {
+                for (std::size_t i = 0; i < rows; i++) {
+                    mismatches += std::fabs(actualValues[i] - expectedValues[i]) > tolerance;
+                }
+            }
+        }
+
+        return mismatches == 0;
+    }
+
+    TLog_Comparison LogComparator::compare(const TLog_Columns& result, const TLog_Columns& reference) const {
+        TLog_Comparison comparison;
+        if (matchesAligned(result, reference)) {    /// Every reference row is then matched with the result row at its position
+            return comparison;
+        }
+
+        /// Hashes of the result rows with the rows, sorted, so rows with equal hash are adjacent and ascending
+        std::vector<std::pair<std::uint64_t, std::size_t>> index;
+        index.reserve(result.size());
+        const int noOffsets[NUMERIC_COLUMNS] = {};
+        const double noDistances[NUMERIC_COLUMNS] = {};
+        for (std::size_t j = 0; j < result.size(); j++) {
+            index.emplace_back(hashOf(makeKey(result, j, m_cellWidths, noDistances), noOffsets), j);
+        }
+        std::sort(index.begin(), index.end());
+        /// Range of every hash in the index, so looking up a hash doesn't have to search the whole index
+        std::unordered_map<std::uint64_t, std::pair<std::size_t, std::size_t>> buckets;
+        buckets.reserve(index.size());
+        for (std::size_t begin = 0, end; begin < index.size(); begin = end) {
+            for (end = begin + 1; end < index.size() && index[end].first == index[begin].first; end++);
+            buckets.emplace(index[begin].first, std::make_pair(begin, end));
+        }
+
+        std::vector<bool> matched(result.size(), false);
+        std::size_t nextRow = 0;    /// The first result row which may be matched
+        for (std::size_t i = 0; i < reference.size(); i++) {
+            double distances[NUMERIC_COLUMNS];
+            for (std::size_t slot = 0; slot < NUMERIC_COLUMNS; slot++) {
+                distances[slot] = m_cellWidths[slot] > 0.0 ? 1.01 * getTolerance(slot, reference.signal[i]).value / m_cellWidths[slot] : 0.0;
+            }
+            const TRow_Key key = makeKey(reference, i, m_cellWidths, distances);
+
+            /// Looking into the cells of the numeric values and into the neighbouring ones where the value
+            /// is within the tolerance from the edge of its cell
+            std::size_t found = TLog_Comparison::npos;
+            int offsets[NUMERIC_COLUMNS];
+            std::copy(std::begin(key.lowestOffset), std::end(key.lowestOffset), std::begin(offsets));
+            for (bool probing = true; probing; ) {
+                const auto bucket = buckets.find(hashOf(key, offsets));
+                if (bucket != buckets.end()) {
+                    const auto end = index.begin() + bucket->second.second;
+                    for (auto candidate = std::lower_bound(index.begin() + bucket->second.first, end, std::make_pair(bucket->first, nextRow));
+                         candidate != end && candidate->second < found; ++candidate) {
+                        if (rowsMatch(result, candidate->second, reference, i)) {
+                            found = candidate->second;
+                            break;
+                        }
+                    }
+                }
+
+                /// Next combination of offsets of the numeric cells, like an odometer
+                probing = false;
+                for (std::size_t slot = 0; slot < NUMERIC_COLUMNS; slot++) {
+                    if (offsets[slot] < key.highestOffset[slot]) {
+                        offsets[slot]++;
+                        probing = true;
+                        break;
+                    }
+                    offsets[slot] = key.lowestOffset[slot];
+                }
+            }
+
+            if (found != TLog_Comparison::npos) {
+                matched[found] = true;
+                nextRow = found + 1;
+            } else {
+                if (comparison.missing.empty() && nextRow < result.size()) {
+                    comparison.firstMismatch = nextRow;
+                }
+                comparison.missing.push_back(i);
+            }
+        }
+
+        for (std::size_t j = 0; j < result.size(); j++) {
+            if (!matched[j]) {
+                comparison.redundant.push_back(j);
+            }
+        }
+
+        return comparison;
+    }
+}
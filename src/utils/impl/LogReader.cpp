@@ -0,0 +1,185 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include "../LogReader.h"
+#include "../DelimiterScanner.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace tester {
+
+    /// Separator of the tokens, followed by a space
+    constexpr char DELIMITER = DelimiterScanner::DELIMITER;
+    constexpr std::size_t DELIMITER_LENGTH = 2;
+    /// Size of the blocks scanned at once, so the found positions stay in the cache
+    constexpr std::size_t SCAN_BLOCK = 256 * 1024;
+
+    LogReader::LogReader(const std::string& logPath) {
+#ifdef _WIN32
+        m_file = CreateFileA(logPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            m_file = nullptr;
+            throw std::runtime_error("Error while opening log file!");
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(m_file, &size)) {
+            close();
+            throw std::runtime_error("Error while opening log file!");
+        }
+        m_size = static_cast<std::size_t>(size.QuadPart);
+
+        if (m_size > 0) {   /// Empty files can't be mapped
+            m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            m_data = m_mapping ? static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (m_data == nullptr) {
+                close();
+                throw std::runtime_error("Error while mapping log file!");
+            }
+        }
+#else
+        const int file = open(logPath.c_str(), O_RDONLY);
+        if (file < 0) {
+            throw std::runtime_error("Error while opening log file!");
+        }
+
+        struct stat status{};
+        if (fstat(file, &status) != 0) {
+            ::close(file);
+            throw std::runtime_error("Error while opening log file!");
+        }
+        m_size = static_cast<std::size_t>(status.st_size);
+
+        if (m_size > 0) {   /// Empty files can't be mapped
+            void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data == MAP_FAILED) {
+                ::close(file);
+                throw std::runtime_error("Error while mapping log file!");
+            }
+            madvise(data, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(data);
+        }
+        ::close(file);  /// The mapping stays valid without the descriptor
+#endif
+
+    }
+
+    LogReader::~LogReader() {
+        close();
+    }
+
+    void LogReader::tokenize(const std::string_view line, TLog_Line& tokens) {
+        tokens.clear();
+        const char* const lineEnd = line.data() + line.size();
+        const char* token = line.data();
+        for (const char* delimiter; token < lineEnd
+                && (delimiter = static_cast<const char*>(std::memchr(token, DELIMITER, static_cast<std::size_t>(lineEnd - token)))) != nullptr; ) {
+            tokens.emplace_back(token, static_cast<std::size_t>(delimiter - token));
+            token = delimiter + std::min<std::size_t>(DELIMITER_LENGTH, static_cast<std::size_t>(lineEnd - delimiter));
+        }
+    }
+
+    void LogReader::forEachLine(const std::function<void(std::string_view line, const TLog_Line& tokens)>& callback) const {
+        forEachLine(getText(), callback);
+    }
+
+    void LogReader::forEachLine(const std::string_view text, const std::function<void(std::string_view line, const TLog_Line& tokens)>& callback) {
+        const char* const end = text.data() + text.size();
+        TLog_Line tokens;
+        std::vector<std::uint32_t> positions;
+        for (const char* block = text.data(); block < end; ) {
+            /// Blocks end after a line break, so no line is split between two blocks
+            const char* blockEnd = block + std::min(SCAN_BLOCK, static_cast<std::size_t>(end - block));
+            if (blockEnd < end) {
+                auto lineEnd = static_cast<const char*>(std::memchr(blockEnd, '\n', static_cast<std::size_t>(end - blockEnd)));
+                blockEnd = lineEnd == nullptr ? end : lineEnd + 1;
+            }
+            DelimiterScanner::scan(std::string_view(block, static_cast<std::size_t>(blockEnd - block)), positions);
+
+            const char* line = block;
+            const char* token = block;
+            tokens.clear();
+            for (const std::uint32_t position : positions) {
+                const char* found = block + position;
+                if (*found == DelimiterScanner::LINE_BREAK) {
+                    callback(std::string_view(line, static_cast<std::size_t>(found - line)), tokens);
+                    line = token = found + 1;
+                    tokens.clear();
+                } else if (found >= token) {    /// The character following a separator is skipped even if it's another one
+                    tokens.emplace_back(token, static_cast<std::size_t>(found - token));
+                    token = found + std::min<std::size_t>(DELIMITER_LENGTH, static_cast<std::size_t>(blockEnd - found));
+                }
+            }
+
+            if (line < blockEnd) {      /// The last line of the file without a line break
+                callback(std::string_view(line, static_cast<std::size_t>(blockEnd - line)), tokens);
+            }
+            block = blockEnd;
+        }
+    }
+
+    std::string_view LogReader::getText() const {
+        return std::string_view(m_data, m_size);
+    }
+
+    std::vector<std::string_view> LogReader::splitLines(const std::string_view text, const std::size_t count) {
+        std::vector<std::string_view> chunks;
+        const std::size_t chunkSize = text.size() / std::max<std::size_t>(count, 1);
+        for (std::size_t begin = 0; begin < text.size(); ) {
+            std::size_t end = text.size();
+            if (chunks.size() + 1 < count) {
+                end = text.find('\n', begin + std::max<std::size_t>(chunkSize, 1) - 1);
+                end = end == std::string_view::npos ? text.size() : end + 1;
+            }
+            chunks.push_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        return chunks;
+    }
+
+    void LogReader::close() {
+#ifdef _WIN32
+        if (m_data != nullptr) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != nullptr) {
+            CloseHandle(m_file);
+        }
+        m_mapping = nullptr;
+        m_file = nullptr;
+#else
+        if (m_data != nullptr) {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    TLog_Lines& LogReader::getLines() {
+        if (!m_tokenized) {
+            forEachLine([this](std::string_view, const TLog_Line& tokens) {
+                m_lines.push_back(tokens);
+            });
+            m_tokenized = true;
+        }
+        return m_lines;
+    }
+}
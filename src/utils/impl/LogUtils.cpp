@@ -6,46 +6,46 @@
 
 namespace log {
 
-    void printResult(const HRESULT result) {
+    void printResult(const HRESULT result, std::wostream& output, std::wostream& errorOutput) {
         switch (result) {
             case S_OK:
-                std::wcout << "OK!\n";
+                output << "OK!\n";
                 Logger::getInstance().info(L"Test result: OK!");
                 break;
             case S_FALSE:
-                std::wcout << "FAIL!\n";
+                output << "FAIL!\n";
                 Logger::getInstance().error(L"Test result: FAIL!");
                 break;
             case E_FAIL:
-                std::wcout << "ERROR!\n";
+                output << "ERROR!\n";
                 Logger::getInstance().error(L"Test result: ERROR!");
                 break;
             default:
-                std::wcerr << "UNKNOWN!\n";
+                errorOutput << "UNKNOWN!\n";
                 Logger::getInstance().info(L"Test result: UNKNOWN!");
                 break;
         }
     }
 
-    void errorLogLine(const std::vector<std::string>& line) {
+    void errorLogLine(const tester::TLog_Line& line) {
         std::string printedLine;
         for (const auto & token : line) {
-            printedLine += (token + "; ");
+            printedLine.append(token).append("; ");
         }
 
         Logger::getInstance().error(Widen_Char(printedLine.c_str()));
     }
 
-    void infoLogLine(const std::vector<std::string> &line) {
+    void infoLogLine(const tester::TLog_Line& line) {
         std::string printedLine;
         for (const auto & token : line) {
-            printedLine += (token + "; ");
+            printedLine.append(token).append("; ");
         }
 
         Logger::getInstance().info(Widen_Char(printedLine.c_str()));
     }
 
-    void infoLogLines(const std::vector<std::vector<std::string>>& lines) {
+    void infoLogLines(const tester::TLog_Lines& lines) {
         for (auto & line : lines) {
             infoLogLine(line);
         }
@@ -69,59 +69,4 @@ namespace log {
         Logger::getInstance().error(std::wstring(L"expected configuration result: ") + Describe_Error(expected));
         Logger::getInstance().error(std::wstring(L"actual configuration result: ") + Describe_Error(result));
     }
-
-    std::vector<std::vector<std::string>> readLogFile(const std::string& logPath) {
-        std::string line;
-        std::string delimiter = ";";
-
-        std::ifstream logFile(logPath);
-        if (!logFile) {
-            throw std::runtime_error("Error while opening log file!");
-        }
-
-        std::vector<std::vector<std::string>> loggedData;
-
-        while (std::getline(logFile, line)) {
-            size_t pos;
-            std::vector<std::string> tmpVec;
-            while ((pos = line.find(delimiter)) != std::string::npos) {
-                tmpVec.push_back(line.substr(0, pos));
-                line.erase(0, pos + delimiter.length() + 1);
-            }
-
-            loggedData.push_back(tmpVec);
-        }
-
-        return loggedData;
-    }
-
-    bool compareLines(const std::vector<std::string>& resultLogLine, const std::vector<std::string>& referenceLogLine) {
-        for (size_t i = cnst::firstComparedIndex; i < referenceLogLine.size(); i++) {
-
-            if ((i >= cnst::firstNumberValueIndex) && (i <= cnst::lastNumberValueIndex)) {
-                std::string expectedField = referenceLogLine.at(i);
-                std::string actualField = resultLogLine.at(i);
-
-                if (expectedField.empty() && actualField.empty()) {
-                    continue;
-                } else if (expectedField.empty() || actualField.empty()) {
-                    return false;
-                }
-
-                double expected = std::stod(referenceLogLine.at(i));
-                double actual = std::stod(resultLogLine.at(i));
-                double lambda = 0.0001;
-
-                if (abs(expected - actual) > lambda) {
-                    return false;
-                }
-            } else {
-                if (referenceLogLine.at(i) != resultLogLine.at(i)) {
-                    return false;
-                }
-            }
-        }
-
-        return true;
-    }
-}
\ No newline at end of file
+}
@@ -10,9 +10,24 @@
 #include <utils/string_utils.h>
 #include "../Logger.h"
 
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
     Logger::Logger() {
-        filesystem::create_directory("../../logs");
-        m_stream.open("../../logs/" + currentDate() + ".log", std::ios::app);
+        filesystem::create_directory(getLogDirectory());
+        m_stream.open(getLogDirectory() + currentDate() + ".log", std::ios::app);
+#ifndef _WIN32
+        pthread_atfork(&Logger::lockBeforeFork, &Logger::unlockAfterFork, &Logger::unlockAfterFork);
+#endif
+    }
+
+    void Logger::lockBeforeFork() {
+        getInstance().m_mutex.lock();
+    }
+
+    void Logger::unlockAfterFork() {
+        getInstance().m_mutex.unlock();
     }
 
     void Logger::error(const std::wstring &text) {
@@ -34,6 +49,7 @@
     }
 
     void Logger::log(const std::wstring &text, const std::wstring &level) {
+        std::lock_guard<std::mutex> lock(m_mutex);   /// localtime used by currentTime is not reentrant either
         std::wstring logText = Widen_Char(currentTime().c_str()) + L" " + level + L"\t" + text + L'\n';
         m_stream << logText;
         m_stream.flush();
@@ -44,6 +60,10 @@
         return instance;
     }
 
+    std::string Logger::getLogDirectory() {
+        return "../../logs/";
+    }
+
     std::string currentTime() {
         return dateTimeInFormat("%Y-%m-%d %H:%M:%S");
     }
@@ -0,0 +1,105 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include "../ResourceMeter.h"
+
+#ifndef _WIN32
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+#include <dirent.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <fstream>
+#endif
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
+namespace tester {
+
+    ResourceMeter::ResourceMeter(const bool processWide)
+            : m_processWide(processWide), m_start(sample()), m_startTime(std::chrono::steady_clock::now()) {
+        //
+    }
+
+    TTest_Metrics ResourceMeter::sample() const {
+        TTest_Metrics metrics;
+#ifndef _WIN32
+        rusage usage{};
+#ifdef RUSAGE_THREAD
+        getrusage(m_processWide ? RUSAGE_SELF : RUSAGE_THREAD, &usage);
+#else
+        getrusage(RUSAGE_SELF, &usage);
+#endif
+        metrics.userTime = usage.ru_utime.tv_sec * 1000.0 + usage.ru_utime.tv_usec / 1000.0;
+        metrics.systemTime = usage.ru_stime.tv_sec * 1000.0 + usage.ru_stime.tv_usec / 1000.0;
+        metrics.voluntaryContextSwitches = usage.ru_nvcsw;
+        metrics.involuntaryContextSwitches = usage.ru_nivcsw;
+
+        rusage processUsage{};      /// Peak RSS is tracked per process only
+        getrusage(RUSAGE_SELF, &processUsage);
+#ifdef __APPLE__
+        metrics.peakRssDelta = processUsage.ru_maxrss / 1024;     /// Reported in bytes on macOS
+#else
+        metrics.peakRssDelta = processUsage.ru_maxrss;
+#endif
+#endif
+        return metrics;
+    }
+
+#if defined(__linux__) || defined(__APPLE__)
+    /// Returns number of entries in given directory listing the process' file descriptors, -1 if it can't be read
+    static long countDescriptors(const char* directory) {
+        DIR* descriptors = opendir(directory);
+        if (descriptors == nullptr) {
+            return -1;
+        }
+
+        long count = 0;
+        while (const dirent* entry = readdir(descriptors)) {
+            if (entry->d_name[0] != '.') {
+                count++;
+            }
+        }
+        closedir(descriptors);
+        return count - 1;   /// Not counting the descriptor of the listed directory itself
+    }
+#endif
+
+    TProcess_Usage sampleProcessUsage() {
+        TProcess_Usage usage;
+#if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        long totalPages, residentPages;
+        if (statm >> totalPages >> residentPages) {
+            usage.rss = residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+        usage.openFiles = countDescriptors("/proc/self/fd");
+#elif defined(__APPLE__)
+        mach_task_basic_info info{};
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+            usage.rss = static_cast<long>(info.resident_size / 1024);
+        }
+        usage.openFiles = countDescriptors("/dev/fd");
+#endif
+        return usage;
+    }
+
+    TTest_Metrics ResourceMeter::stop() const {
+        TTest_Metrics end = sample();
+        TTest_Metrics metrics;
+
+        metrics.wallTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startTime).count();
+        metrics.userTime = end.userTime - m_start.userTime;
+        metrics.systemTime = end.systemTime - m_start.systemTime;
+        metrics.peakRssDelta = end.peakRssDelta - m_start.peakRssDelta;
+        metrics.voluntaryContextSwitches = end.voluntaryContextSwitches - m_start.voluntaryContextSwitches;
+        metrics.involuntaryContextSwitches = end.involuntaryContextSwitches - m_start.involuntaryContextSwitches;
+        return metrics;
+    }
+}
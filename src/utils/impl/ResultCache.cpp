@@ -0,0 +1,237 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "../ResultCache.h"
+#include "../constants.h"
+#include "../Logger.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach-o/dyld.h>
+#include <climits>
+#include <cstdlib>
+#else
+#include <unistd.h>
+#include <climits>
+#endif
+
+namespace tester {
+
+    constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+    /// Mixes given bytes into FNV-1a hash
+    static void fnvMix(std::uint64_t& hash, const char* data, std::size_t length) {
+        for (std::size_t i = 0; i < length; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= FNV_PRIME;
+        }
+    }
+
+    ResultCache::ResultCache() : m_enabled(false), m_loaded(false) {
+        //
+    }
+
+    ResultCache& ResultCache::getInstance() {
+        static ResultCache instance;
+        return instance;
+    }
+
+    std::string ResultCache::getCachePath() {
+        return Logger::getLogDirectory() + "result_cache.csv";
+    }
+
+    std::wstring ResultCache::makeKey(const std::wstring& suite, const std::wstring& name) {
+        return suite + L"/" + name;
+    }
+
+    std::string ResultCache::resolveExecutable(const std::string& executable) {
+        /// argv[0] is only the name of the executable when it was found through PATH, so the system is asked instead
+#ifdef _WIN32
+        char path[MAX_PATH];
+        const DWORD length = GetModuleFileNameA(nullptr, path, MAX_PATH);
+        if (length > 0 && length < MAX_PATH) {
+            return std::string(path, length);
+        }
+#elif defined(__APPLE__)
+        char path[PATH_MAX];
+        uint32_t size = sizeof(path);
+        char resolved[PATH_MAX];
+        if (_NSGetExecutablePath(path, &size) == 0 && realpath(path, resolved)) {
+            return resolved;
+        }
+#else
+        char path[PATH_MAX];
+        const ssize_t length = readlink("/proc/self/exe", path, sizeof(path));
+        if (length > 0 && static_cast<std::size_t>(length) < sizeof(path)) {
+            return std::string(path, static_cast<std::size_t>(length));
+        }
+#endif
+        Logger::getInstance().warn(L"Couldn't determine path to the tester executable, using the path it was started with.");
+        return executable;
+    }
+
+    void ResultCache::enable(const std::string& executable) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_executable = resolveExecutable(executable);
+        m_enabled = true;
+    }
+
+    bool ResultCache::isEnabled() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_enabled;
+    }
+
+    void ResultCache::load() {
+        m_loaded = true;
+
+        std::wifstream file(getCachePath());
+        std::wstring line;
+        while (std::getline(file, line)) {      /// key; hash
+            std::size_t separator = line.rfind(L"; ");
+            if (separator == std::wstring::npos) {
+                continue;
+            }
+
+            try {
+                m_passed[line.substr(0, separator)] = std::stoull(line.substr(separator + 2), nullptr, 16);
+            } catch (const std::exception&) {
+                Logger::getInstance().warn(L"Invalid line in result cache: " + line);
+            }
+        }
+    }
+
+    std::uint64_t ResultCache::hashFile(const filesystem::path& path) {
+        auto cached = m_fileHashes.find(path.wstring());
+        if (cached != m_fileHashes.end()) {
+            return cached->second;
+        }
+
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            Logger::getInstance().warn(L"Couldn't read " + path.wstring() + L", tests depending on it won't be cached.");
+            return NO_HASH;     /// Not caching, the file may appear later
+        }
+
+        std::uint64_t hash = FNV_OFFSET_BASIS;
+        std::vector<char> buffer(1 << 16);
+        while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
+            fnvMix(hash, buffer.data(), static_cast<std::size_t>(file.gcount()));
+        }
+        if (file.bad()) {
+            Logger::getInstance().warn(L"Error while reading " + path.wstring() + L", tests depending on it won't be cached.");
+            return NO_HASH;
+        }
+
+        m_fileHashes[path.wstring()] = hash;
+        return hash;
+    }
+
+    bool ResultCache::mixFile(std::uint64_t& hash, const filesystem::path& path) {
+        const std::string name = path.generic_string();
+        const std::uint64_t content = hashFile(path);
+        fnvMix(hash, name.data(), name.size());
+        fnvMix(hash, reinterpret_cast<const char*>(&content), sizeof(content));
+        return content != NO_HASH;
+    }
+
+    std::uint64_t ResultCache::hashUnitInputs(const std::wstring& libraryFile) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::uint64_t hash = FNV_OFFSET_BASIS;
+        bool readable = mixFile(hash, m_executable);
+        readable &= mixFile(hash, std::wstring(cnst::SCGMS_LIB) + cnst::LIB_EXTENSION);
+        readable &= mixFile(hash, libraryFile);
+        return readable ? hash : NO_HASH;
+    }
+
+    std::uint64_t ResultCache::hashRegressionInputs(const filesystem::path& scenarioDirectory) {
+        std::vector<filesystem::path> files;
+        for (const auto& entry : filesystem::directory_iterator(scenarioDirectory)) {
+            if (entry.is_regular_file()) {
+                files.push_back(entry.path());
+            }
+        }
+
+        /// Configuration may reference any filter, all libraries scgms would load have to be considered
+        const filesystem::path filterDirectory = filesystem::path(cnst::LOG_LIBRARY).parent_path();
+        if (filesystem::is_directory(filterDirectory)) {
+            for (const auto& entry : filesystem::directory_iterator(filterDirectory)) {
+                if (entry.is_regular_file() && entry.path().extension() == cnst::LIB_EXTENSION) {
+                    files.push_back(entry.path());
+                }
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::uint64_t hash = FNV_OFFSET_BASIS;
+        bool readable = mixFile(hash, m_executable);
+        readable &= mixFile(hash, std::wstring(cnst::SCGMS_LIB) + cnst::LIB_EXTENSION);
+        for (const auto& file : files) {
+            readable &= mixFile(hash, file);
+        }
+        return readable ? hash : NO_HASH;
+    }
+
+    bool ResultCache::hasPassed(const std::wstring& suite, const std::wstring& name, const std::uint64_t inputHash) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled || inputHash == NO_HASH) {
+            return false;
+        }
+
+        if (!m_loaded) {
+            load();
+        }
+
+        auto passed = m_passed.find(makeKey(suite, name));
+        return passed != m_passed.end() && passed->second == inputHash;
+    }
+
+    void ResultCache::record(const std::wstring& suite, const std::wstring& name, const std::uint64_t inputHash,
+                             const HRESULT result) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) {
+            return;
+        }
+
+        if (!m_loaded) {
+            load();
+        }
+
+        if (result == S_OK && inputHash != NO_HASH) {
+            m_passed[makeKey(suite, name)] = inputHash;
+        } else {
+            m_passed.erase(makeKey(suite, name));
+        }
+    }
+
+    void ResultCache::save() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) {
+            return;
+        }
+
+        if (!m_loaded) {
+            load();
+        }
+
+        std::wofstream file(getCachePath());
+        if (!file) {
+            Logger::getInstance().error(L"Couldn't write result cache!");
+            return;
+        }
+
+        for (const auto& passed : m_passed) {
+            file << passed.first << L"; " << std::hex << passed.second << std::dec << L'\n';
+        }
+    }
+}
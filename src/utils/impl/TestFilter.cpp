@@ -4,7 +4,13 @@
 #include "../TestFilter.h"
 #include "../constants.h"
 
-TestFilter::TestFilter() : m_receivedEvent() {
+/// Stamp of a slot holding event with given sequence; odd stamps mark slots being written
+static constexpr std::uint64_t publishedStamp(const std::uint64_t sequence) {
+    return 2 * sequence + 2;
+}
+
+TestFilter::TestFilter(const std::size_t capacity)
+        : m_slots(new TSlot[capacity]), m_capacity(capacity), m_next(0) {
 }
 
 HRESULT IfaceCalling TestFilter::Configure(IFilter_Configuration* configuration, refcnt::wstr_list *error_description){
@@ -19,12 +25,113 @@ HRESULT IfaceCalling TestFilter::Execute(scgms::IDevice_Event *event) {
 
     scgms::TDevice_Event *rawEvent;
     event->Raw(&rawEvent);
-    m_receivedEvent = *rawEvent;
+
+    const std::uint64_t sequence = m_next.fetch_add(1, std::memory_order_relaxed);
+    TSlot& slot = m_slots[sequence % m_capacity];
+    slot.stamp.store(publishedStamp(sequence) - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.entry.event = *rawEvent;
+    slot.entry.sequence = sequence;
+    slot.entry.arrival = std::chrono::steady_clock::now();
+    slot.stamp.store(publishedStamp(sequence), std::memory_order_release);
 
     event->Release();   /// Copying acquired data and releasing, so we don't need to manually release in every test
     return S_OK;
 }
 
-const scgms::TDevice_Event& TestFilter::getReceivedEvent() {
-    return m_receivedEvent;
-}
\ No newline at end of file
+bool TestFilter::readEntry(const std::uint64_t sequence, TReceived_Event& entry) const {
+    const TSlot& slot = m_slots[sequence % m_capacity];
+    if (slot.stamp.load(std::memory_order_acquire) != publishedStamp(sequence)) {
+        return false;   /// Not written yet, or already overwritten
+    }
+
+    entry = slot.entry;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.stamp.load(std::memory_order_relaxed) == publishedStamp(sequence);
+}
+
+void TestFilter::reset() {
+    for (std::size_t i = 0; i < m_capacity; i++) {
+        m_slots[i].stamp.store(0, std::memory_order_relaxed);
+    }
+    m_next.store(0, std::memory_order_release);
+}
+
+void TestFilter::reset(std::size_t capacity) {
+    capacity = capacity > 0 ? capacity : 1;
+    if (capacity != m_capacity) {
+        m_slots.reset(new TSlot[capacity]);
+        m_capacity = capacity;
+    }
+    reset();
+}
+
+scgms::TDevice_Event TestFilter::getReceivedEvent() const {
+    const std::uint64_t next = m_next.load(std::memory_order_acquire);
+    const std::uint64_t oldest = next > m_capacity ? next - m_capacity : 0;
+
+    TReceived_Event entry;
+    for (std::uint64_t sequence = next; sequence > oldest; sequence--) {
+        if (readEntry(sequence - 1, entry)) {
+            return entry.event;
+        }
+    }
+
+    return scgms::TDevice_Event();
+}
+
+std::uint64_t TestFilter::getReceivedCount() const {
+    return m_next.load(std::memory_order_acquire);
+}
+
+std::uint64_t TestFilter::getOverwrittenCount() const {
+    const std::uint64_t received = getReceivedCount();
+    return received > m_capacity ? received - m_capacity : 0;
+}
+
+std::size_t TestFilter::getCapacity() const {
+    return m_capacity;
+}
+
+std::vector<TestFilter::TReceived_Event> TestFilter::getReceivedEvents() const {
+    const std::uint64_t next = m_next.load(std::memory_order_acquire);
+    const std::uint64_t oldest = next > m_capacity ? next - m_capacity : 0;
+
+    std::vector<TReceived_Event> events;
+    events.reserve(static_cast<std::size_t>(next - oldest));
+
+    TReceived_Event entry;
+    for (std::uint64_t sequence = oldest; sequence < next; sequence++) {
+        if (readEntry(sequence, entry)) {
+            events.push_back(entry);
+        }
+    }
+
+    return events;
+}
+
+std::size_t TestFilter::countReceived(const scgms::NDevice_Event_Code eventCode) const {
+    std::size_t count = 0;
+    for (const TReceived_Event& received : getReceivedEvents()) {
+        if (received.event.event_code == eventCode) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+bool TestFilter::receivedInOrder(const std::vector<scgms::NDevice_Event_Code>& eventCodes) const {
+    auto expected = eventCodes.begin();
+    for (const TReceived_Event& received : getReceivedEvents()) {
+        if (expected == eventCodes.end()) {
+            break;
+        }
+
+        if (received.event.event_code == *expected) {
+            ++expected;
+        }
+    }
+
+    return expected == eventCodes.end();
+}
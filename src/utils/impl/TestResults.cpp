@@ -0,0 +1,182 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <utils/string_utils.h>
+#include "../TestResults.h"
+#include "../Logger.h"
+
+namespace tester {
+
+    ResultCollector& ResultCollector::getInstance() {
+        static ResultCollector instance;
+        return instance;
+    }
+
+    void ResultCollector::add(TTest_Result result) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_results.push_back(std::move(result));
+    }
+
+    std::vector<TTest_Result> ResultCollector::getResults() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_results;
+    }
+
+    std::vector<TTest_Result> ResultCollector::sortedResults() {
+        std::vector<TTest_Result> results = getResults();
+        std::stable_sort(results.begin(), results.end(), [](const TTest_Result& first, const TTest_Result& second) {
+            return first.suite < second.suite;
+        });
+        return results;
+    }
+
+    std::wstring describeStatus(const TTest_Result& result) {
+        if (!result.abnormalEnd.empty()) {
+            return result.abnormalEnd;
+        }
+
+        switch (result.result) {
+            case S_OK: return L"OK";
+            case S_FALSE: return L"FAIL";
+            case E_FAIL: return L"ERROR";
+            default: return L"UNKNOWN";
+        }
+    }
+
+    /// Escapes given text to be placed inside a JSON string
+    static std::string escapeJson(const std::wstring& text) {
+        std::string escaped;
+        for (char c : Narrow_WString(text)) {
+            switch (c) {
+                case '"': escaped += "\\\""; break;
+                case '\\': escaped += "\\\\"; break;
+                case '\n': escaped += "\\n"; break;
+                case '\t': escaped += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        std::ostringstream code;
+                        code << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                        escaped += code.str();
+                    } else {
+                        escaped += c;
+                    }
+            }
+        }
+        return escaped;
+    }
+
+    /// Escapes given text to be placed inside an XML attribute
+    static std::string escapeXml(const std::wstring& text) {
+        std::string escaped;
+        for (char c : Narrow_WString(text)) {
+            switch (c) {
+                case '"': escaped += "&quot;"; break;
+                case '&': escaped += "&amp;"; break;
+                case '<': escaped += "&lt;"; break;
+                case '>': escaped += "&gt;"; break;
+                default: escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    bool ResultCollector::writeJson(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        std::vector<TTest_Result> results = sortedResults();
+        file << "{\n  \"timestamp\": \"" << currentTime() << "\",\n  \"tests\": [";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const TTest_Result& result = results[i];
+            file << (i == 0 ? "\n" : ",\n")
+                 << "    {\"suite\": \"" << escapeJson(result.suite) << "\", "
+                 << "\"name\": \"" << escapeJson(result.name) << "\", "
+                 << "\"status\": \"" << escapeJson(describeStatus(result)) << "\", "
+                 << "\"cached\": " << (result.cached ? "true" : "false") << ", "
+                 << "\"wall_ms\": " << result.metrics.wallTime << ", "
+                 << "\"user_ms\": " << result.metrics.userTime << ", "
+                 << "\"sys_ms\": " << result.metrics.systemTime << ", "
+                 << "\"peak_rss_delta_kb\": " << result.metrics.peakRssDelta << ", "
+                 << "\"voluntary_context_switches\": " << result.metrics.voluntaryContextSwitches << ", "
+                 << "\"involuntary_context_switches\": " << result.metrics.involuntaryContextSwitches << "}";
+        }
+        file << "\n  ]\n}\n";
+
+        return static_cast<bool>(file);
+    }
+
+    bool ResultCollector::writeJUnit(const std::string& path) {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        std::vector<TTest_Result> results = sortedResults();
+        file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n";
+
+        for (std::size_t first = 0; first < results.size(); ) {
+            std::size_t last = first;
+            std::size_t failures = 0, errors = 0;
+            double time = 0.0;
+            while (last < results.size() && results[last].suite == results[first].suite) {
+                if (results[last].result == S_FALSE && results[last].abnormalEnd.empty()) {
+                    failures++;
+                } else if (results[last].result != S_OK || !results[last].abnormalEnd.empty()) {
+                    errors++;
+                }
+                time += results[last].metrics.wallTime / 1000.0;
+                last++;
+            }
+
+            file << "  <testsuite name=\"" << escapeXml(results[first].suite) << "\" tests=\"" << (last - first)
+                 << "\" failures=\"" << failures << "\" errors=\"" << errors << "\" time=\"" << time << "\">\n";
+
+            for (std::size_t i = first; i < last; i++) {
+                const TTest_Result& result = results[i];
+                const TTest_Metrics& metrics = result.metrics;
+                file << "    <testcase classname=\"" << escapeXml(result.suite) << "\" name=\"" << escapeXml(result.name)
+                     << "\" time=\"" << metrics.wallTime / 1000.0 << "\">\n";
+
+                if (result.result == S_FALSE && result.abnormalEnd.empty()) {
+                    file << "      <failure message=\"" << escapeXml(describeStatus(result)) << "\"/>\n";
+                } else if (result.result != S_OK || !result.abnormalEnd.empty()) {
+                    file << "      <error message=\"" << escapeXml(describeStatus(result)) << "\"/>\n";
+                }
+
+                file << "      <system-out>user_ms=" << metrics.userTime << " sys_ms=" << metrics.systemTime
+                     << " peak_rss_delta_kb=" << metrics.peakRssDelta
+                     << " voluntary_context_switches=" << metrics.voluntaryContextSwitches
+                     << " involuntary_context_switches=" << metrics.involuntaryContextSwitches << "</system-out>\n"
+                     << "    </testcase>\n";
+            }
+
+            file << "  </testsuite>\n";
+            first = last;
+        }
+
+        file << "</testsuites>\n";
+        return static_cast<bool>(file);
+    }
+
+    void ResultCollector::writeReports() {
+        if (getResults().empty()) {
+            return;
+        }
+
+        std::string basePath = Logger::getLogDirectory() + dateTimeInFormat("%Y-%m-%d_%H-%M-%S");
+        if (!writeJson(basePath + ".json")) {
+            Logger::getInstance().error(L"Couldn't write JSON test report!");
+        }
+        if (!writeJUnit(basePath + ".xml")) {
+            Logger::getInstance().error(L"Couldn't write JUnit test report!");
+        }
+        Logger::getInstance().info(L"Test reports written to " + Widen_String(basePath) + L".json/.xml");
+    }
+}
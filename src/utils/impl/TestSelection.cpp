@@ -0,0 +1,56 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <stdexcept>
+#include "../TestSelection.h"
+
+namespace tester {
+
+    TestSelection::TestSelection() : m_hasPattern(false), m_shardIndex(0), m_shardCount(1) {
+        //
+    }
+
+    TestSelection& TestSelection::getInstance() {
+        static TestSelection instance;
+        return instance;
+    }
+
+    void TestSelection::setPattern(const std::wstring& pattern) {
+        m_pattern = std::wregex(pattern, std::regex_constants::ECMAScript);
+        m_hasPattern = true;
+    }
+
+    void TestSelection::setShard(const unsigned int index, const unsigned int count) {
+        if (count == 0 || index >= count) {
+            throw std::invalid_argument("Invalid shard");
+        }
+
+        m_shardIndex = index;
+        m_shardCount = count;
+    }
+
+    std::uint32_t TestSelection::hashIdentifier(const std::wstring& identifier) {
+        /// FNV-1a over code points, so the hash doesn't depend on the size of wchar_t
+        std::uint32_t hash = 2166136261u;
+        for (wchar_t character : identifier) {
+            std::uint32_t codePoint = static_cast<std::uint32_t>(character);
+            for (int i = 0; i < 4; i++) {
+                hash ^= (codePoint >> (8 * i)) & 0xFFu;
+                hash *= 16777619u;
+            }
+        }
+
+        return hash;
+    }
+
+    bool TestSelection::isSelected(const std::wstring& suite, const std::wstring& name) const {
+        const std::wstring identifier = suite + L"/" + name;
+
+        if (m_hasPattern && !std::regex_search(identifier, m_pattern)) {
+            return false;
+        }
+
+        return m_shardCount == 1 || hashIdentifier(identifier) % m_shardCount == m_shardIndex;
+    }
+}
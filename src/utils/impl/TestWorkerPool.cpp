@@ -0,0 +1,151 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <chrono>
+#include <exception>
+#include <utils/string_utils.h>
+#include "../TestWorkerPool.h"
+#include "../Logger.h"
+
+namespace tester {
+
+    /// Number of slots of the timeout wheel
+    constexpr std::size_t TIMER_WHEEL_SLOTS = 512;
+    /// Resolution of test timeouts in milliseconds
+    constexpr long TIMER_WHEEL_TICK = 5;
+
+    TestWorkerPool::TestWorkerPool()
+            : m_timerWheel(TIMER_WHEEL_SLOTS, TIMER_WHEEL_TICK), m_nextJobId(0), m_stopping(false) {
+        m_supervisor = std::thread(&TestWorkerPool::supervisorRoutine, this);
+    }
+
+    TestWorkerPool::~TestWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_queueCv.notify_all();
+        m_supervisorCv.notify_all();
+
+        for (auto &worker : m_workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+        if (m_supervisor.joinable()) {
+            m_supervisor.join();
+        }
+    }
+
+    TestWorkerPool& TestWorkerPool::getInstance() {
+        static TestWorkerPool instance;
+        return instance;
+    }
+
+    void TestWorkerPool::ensureWorkers(const std::size_t count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        while (m_workers.size() < count) {
+            m_workers.emplace_back(&TestWorkerPool::workerRoutine, this);
+        }
+    }
+
+    TestWorkerPool::TJob_Id TestWorkerPool::submit(std::function<HRESULT(void)> test, const long timeout) {
+        ensureWorkers(1);
+
+        TJob_Id id;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            id = m_nextJobId++;
+            TJob &job = m_jobs[id];
+            job.test = std::move(test);
+            job.timeout = timeout;
+            m_queue.push_back(id);
+        }
+
+        m_queueCv.notify_one();
+        return id;
+    }
+
+    TestWorkerPool::NJob_State TestWorkerPool::waitFor(const TJob_Id id, HRESULT &result) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobCv.wait(lock, [this, id]() { return m_jobs[id].finished || m_jobs[id].timedOut; });
+
+        TJob &job = m_jobs[id];
+        if (job.finished) {
+            result = job.result;
+            m_jobs.erase(id);
+            return NJob_State::Finished;
+        }
+
+        return NJob_State::Timed_Out;
+    }
+
+    void TestWorkerPool::waitForCompletion(const TJob_Id id) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_jobCv.wait(lock, [this, id]() { return m_jobs[id].finished; });
+        m_jobs.erase(id);
+    }
+
+    void TestWorkerPool::workerRoutine() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            m_queueCv.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) {      /// Stopping and nothing left to do
+                return;
+            }
+
+            TJob_Id id = m_queue.front();
+            m_queue.pop_front();
+            std::function<HRESULT(void)> test = std::move(m_jobs[id].test);
+            m_timerWheel.schedule(id, m_jobs[id].timeout);
+            m_supervisorCv.notify_one();
+            lock.unlock();
+
+            HRESULT result;
+            try {
+                result = test();
+            } catch (const std::exception &ex) {
+                Logger::getInstance().error(L"Test threw an exception: " + Widen_Char(ex.what()));
+                result = E_FAIL;
+            }
+
+            lock.lock();
+            TJob &job = m_jobs[id];
+            job.result = result;
+            job.finished = true;
+            m_timerWheel.cancel(id);
+            m_jobCv.notify_all();
+        }
+    }
+
+    void TestWorkerPool::supervisorRoutine() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto nextTick = std::chrono::steady_clock::now();
+
+        while (!m_stopping) {
+            if (m_timerWheel.isEmpty()) {       /// Nothing to watch, sleeping until a test starts
+                m_supervisorCv.wait(lock, [this]() { return m_stopping || !m_timerWheel.isEmpty(); });
+                nextTick = std::chrono::steady_clock::now();
+                continue;
+            }
+
+            nextTick += std::chrono::milliseconds(m_timerWheel.getTickLength());
+            m_supervisorCv.wait_until(lock, nextTick, [this]() { return m_stopping; });
+
+            bool anyTimedOut = false;
+            for (TJob_Id id : m_timerWheel.advance()) {
+                auto job = m_jobs.find(id);
+                if (job != m_jobs.end() && !job->second.finished) {   /// Finished jobs are already gone or done
+                    job->second.timedOut = true;
+                    anyTimedOut = true;
+                }
+            }
+
+            if (anyTimedOut) {
+                m_jobCv.notify_all();
+            }
+        }
+    }
+}
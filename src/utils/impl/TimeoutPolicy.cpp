@@ -0,0 +1,133 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "../TimeoutPolicy.h"
+#include "../constants.h"
+#include "../Logger.h"
+
+namespace tester {
+
+    /// Minimum number of recorded durations needed to derive the timeout from them
+    constexpr std::size_t MIN_HISTORY_SAMPLES = 5;
+    /// Maximum number of durations kept for every test
+    constexpr std::size_t MAX_HISTORY_SAMPLES = 50;
+    /// Bounds of derived timeouts in milliseconds
+    constexpr long MIN_ADAPTIVE_TIMEOUT = 50;
+    constexpr long MAX_ADAPTIVE_TIMEOUT = 60000;
+
+    TimeoutPolicy::TimeoutPolicy()
+            : m_defaultTimeout(cnst::MAX_EXEC_TIME), m_adaptiveFactor(0.0), m_historyLoaded(false) {
+        //
+    }
+
+    TimeoutPolicy& TimeoutPolicy::getInstance() {
+        static TimeoutPolicy instance;
+        return instance;
+    }
+
+    std::wstring TimeoutPolicy::makeKey(const std::wstring& suite, const std::wstring& name) {
+        return suite + L"; " + name;
+    }
+
+    std::string TimeoutPolicy::getHistoryPath() {
+        return Logger::getLogDirectory() + "test_history.csv";
+    }
+
+    void TimeoutPolicy::setDefaultTimeout(const long timeout) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_defaultTimeout = timeout;
+    }
+
+    void TimeoutPolicy::setAdaptiveFactor(const double factor) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_adaptiveFactor = factor;
+    }
+
+    void TimeoutPolicy::loadHistory() {
+        m_historyLoaded = true;
+
+        std::wifstream file(getHistoryPath());
+        std::wstring line;
+        while (std::getline(file, line)) {      /// suite; name; duration; duration; ...
+            std::size_t suiteEnd = line.find(L"; ");
+            std::size_t nameEnd = suiteEnd == std::wstring::npos ? std::wstring::npos : line.find(L"; ", suiteEnd + 2);
+            if (nameEnd == std::wstring::npos) {
+                continue;
+            }
+
+            std::deque<double>& durations = m_history[line.substr(0, nameEnd)];
+            std::wistringstream values(line.substr(nameEnd + 2));
+            std::wstring value;
+            while (std::getline(values, value, L';')) {
+                try {
+                    durations.push_back(std::stod(value));
+                } catch (const std::exception&) {
+                    Logger::getInstance().warn(L"Invalid duration in test history: " + value);
+                }
+            }
+        }
+    }
+
+    long TimeoutPolicy::getTimeout(const std::wstring& suite, const std::wstring& name, const long requestedTimeout) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        long timeout = requestedTimeout > 0 ? requestedTimeout : m_defaultTimeout;
+
+        if (m_adaptiveFactor <= 0.0) {
+            return timeout;
+        }
+
+        if (!m_historyLoaded) {
+            loadHistory();
+        }
+
+        auto history = m_history.find(makeKey(suite, name));
+        if (history == m_history.end() || history->second.size() < MIN_HISTORY_SAMPLES) {
+            return timeout;
+        }
+
+        std::vector<double> durations(history->second.begin(), history->second.end());
+        std::size_t rank = static_cast<std::size_t>(std::ceil(0.99 * durations.size())) - 1;
+        std::nth_element(durations.begin(), durations.begin() + rank, durations.end());
+
+        long adaptive = static_cast<long>(std::ceil(durations[rank] * m_adaptiveFactor));
+        return std::clamp(adaptive, MIN_ADAPTIVE_TIMEOUT, MAX_ADAPTIVE_TIMEOUT);
+    }
+
+    void TimeoutPolicy::recordResults(const std::vector<TTest_Result>& results) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_historyLoaded) {
+            loadHistory();
+        }
+
+        for (const TTest_Result& result : results) {
+            if (!result.abnormalEnd.empty() || result.cached) {     /// Timed out, crashed or skipped tests say nothing about healthy duration
+                continue;
+            }
+
+            std::deque<double>& durations = m_history[makeKey(result.suite, result.name)];
+            durations.push_back(result.metrics.wallTime);
+            while (durations.size() > MAX_HISTORY_SAMPLES) {
+                durations.pop_front();
+            }
+        }
+
+        std::wofstream file(getHistoryPath());
+        if (!file) {
+            Logger::getInstance().error(L"Couldn't write test history!");
+            return;
+        }
+
+        for (const auto& history : m_history) {
+            file << history.first;
+            for (double duration : history.second) {
+                file << L"; " << duration;
+            }
+            file << L'\n';
+        }
+    }
+}
@@ -0,0 +1,67 @@
+//
+// Author: markovd@students.zcu.cz
+//
+
+#include "../TimerWheel.h"
+
+namespace tester {
+
+    TimerWheel::TimerWheel(const std::size_t slotCount, const long tickLength)
+            : m_slots(slotCount), m_tickLength(tickLength), m_currentSlot(0) {
+        //
+    }
+
+    void TimerWheel::schedule(const uint64_t id, const long timeout) {
+        /// One extra tick for the partially elapsed current one, so the timer never expires sooner than requested
+        uint64_t ticks = (timeout <= 0 ? 0 : (timeout + m_tickLength - 1) / m_tickLength) + 1;
+        std::size_t slot = (m_currentSlot + ticks - 1) % m_slots.size();
+        m_slots[slot].push_back({ id, (ticks - 1) / m_slots.size() });
+        m_timerSlots[id] = slot;
+    }
+
+    std::vector<uint64_t> TimerWheel::advance() {
+        std::vector<uint64_t> expired;
+        std::vector<TTimer>& slot = m_slots[m_currentSlot];
+
+        for (std::size_t i = 0; i < slot.size(); ) {
+            if (slot[i].rounds == 0) {
+                expired.push_back(slot[i].id);
+                m_timerSlots.erase(slot[i].id);
+                slot[i] = slot.back();
+                slot.pop_back();
+            } else {
+                slot[i].rounds--;
+                i++;
+            }
+        }
+
+        m_currentSlot = (m_currentSlot + 1) % m_slots.size();
+        return expired;
+    }
+
+    bool TimerWheel::cancel(const uint64_t id) {
+        auto timer = m_timerSlots.find(id);
+        if (timer == m_timerSlots.end()) {
+            return false;
+        }
+
+        std::vector<TTimer>& slot = m_slots[timer->second];
+        for (std::size_t i = 0; i < slot.size(); i++) {
+            if (slot[i].id == id) {
+                slot[i] = slot.back();
+                slot.pop_back();
+                break;
+            }
+        }
+        m_timerSlots.erase(timer);
+        return true;
+    }
+
+    bool TimerWheel::isEmpty() const {
+        return m_timerSlots.empty();
+    }
+
+    long TimerWheel::getTickLength() const {
+        return m_tickLength;
+    }
+}
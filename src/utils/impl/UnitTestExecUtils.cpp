@@ -3,12 +3,22 @@
 //
 
 #include <iostream>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
 #include <rtl/guid.h>
 #include <utils/string_utils.h>
+#include <rtl/scgmsLib.h>
 #include "../UnitTestExecUtils.h"
 #include "../../mappers/GuidTesterMapper.h"
 #include "../../mappers/GuidFileMapper.h"
 #include "../constants.h"
+#include "../TestWorkerPool.h"
+#include "../FilterLibraryCache.h"
 
 void tester::executeFilterTests(const GUID& guid) {
     if (Is_Invalid_GUID(guid)) {
@@ -22,13 +32,163 @@ void tester::executeFilterTests(const GUID& guid) {
     delete unitTester;
 }
 
-void tester::executeAllTests() {
+void tester::executeFilterTests(const GUID& guid, std::wostream& output) {
+    tester::GenericUnitTester* unitTester = getUnitTester(guid);
+    if (unitTester == nullptr) {
+        output << L"No tester is matching GUID " << GUID_To_WString(guid) << L"!\n";
+        return;
+    }
+
+    unitTester->setOutput(output, output);
+    unitTester->executeAllTests();
+    delete unitTester;
+}
+
+namespace {
+    /// Console output of a tester executed by a parallel worker
+    struct TTester_Output {
+        std::wostringstream stream;
+        bool finished = false;
+    };
+}
+
+void tester::executeAllTests(unsigned int jobs) {
 	Logger::getInstance().info(L"Executing all tests across all filters.");
 	std::map<GUID, const wchar_t*> map = GuidFileMapper::GetInstance().getMap();
 
+    if (jobs == 0) {
+        jobs = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (jobs == 1) {
+        for (const auto &guidPair : map) {
+            executeFilterTests(guidPair.first);
+        }
+        return;
+    }
+
+    std::vector<GUID> guids;
     for (const auto &guidPair : map) {
-        executeFilterTests(guidPair.first);
+        guids.push_back(guidPair.first);
+    }
+
+    Logger::getInstance().info(L"Executing testers in " + std::to_wstring(jobs) + L" parallel jobs.");
+    std::vector<TTester_Output> outputs(guids.size());
+    std::mutex outputMutex;
+    std::condition_variable outputCv;
+    std::atomic<std::size_t> nextTester{0};
+
+    auto worker = [&]() {
+        std::size_t index;
+        while ((index = nextTester++) < guids.size()) {
+            executeFilterTests(guids[index], outputs[index].stream);
+            {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                outputs[index].finished = true;
+            }
+            outputCv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    std::size_t workerCount = std::min<std::size_t>(jobs, guids.size());
+    TestWorkerPool::getInstance().ensureWorkers(workerCount);     /// Every tester waits for one test at a time
+    for (std::size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+
+    /// Printing every tester's output as soon as it and all testers before it are finished, so the order is stable
+    for (auto &output : outputs) {
+        std::unique_lock<std::mutex> lock(outputMutex);
+        outputCv.wait(lock, [&output]() { return output.finished; });
+        std::wcout << output.stream.str() << std::flush;
+    }
+
+    for (auto &workerThread : workers) {
+        workerThread.join();
+    }
+}
+
+HRESULT tester::executeFilterBenchmark(const GUID& guid, const std::size_t eventCount) {
+    tester::GenericUnitTester* unitTester = getUnitTester(guid);
+    if (unitTester == nullptr) {
+        std::wcerr << L"No tester is matching GUID " << GUID_To_WString(guid) << L"!\n";
+        Logger::getInstance().error(L"No tester is matching GUID " + GUID_To_WString(guid) + L"!");
+        return E_FAIL;
+    }
+
+    HRESULT result = unitTester->executeBenchmark(eventCount);
+    delete unitTester;
+    return result;
+}
+
+HRESULT tester::executeAllBenchmarks(const std::size_t eventCount) {
+    Logger::getInstance().info(L"Benchmarking all filters.");
+
+    HRESULT result = S_OK;
+    for (const auto &guidPair : GuidFileMapper::GetInstance().getMap()) {
+        if (executeFilterBenchmark(guidPair.first, eventCount) != S_OK) {
+            result = E_FAIL;
+        }
+    }
+    return result;
+}
+
+HRESULT tester::executeFilterStressTest(const GUID& guid, const std::size_t eventCount, const unsigned int maxThreads) {
+    tester::GenericUnitTester* unitTester = getUnitTester(guid);
+    if (unitTester == nullptr) {
+        std::wcerr << L"No tester is matching GUID " << GUID_To_WString(guid) << L"!\n";
+        Logger::getInstance().error(L"No tester is matching GUID " + GUID_To_WString(guid) + L"!");
+        return E_FAIL;
+    }
+
+    HRESULT result = unitTester->executeStressTest(eventCount, maxThreads);
+    delete unitTester;
+    return result;
+}
+
+HRESULT tester::executeAllStressTests(const std::size_t eventCount, const unsigned int maxThreads) {
+    Logger::getInstance().info(L"Stress testing all filters.");
+
+    HRESULT result = S_OK;
+    for (const auto &guidPair : GuidFileMapper::GetInstance().getMap()) {
+        if (executeFilterStressTest(guidPair.first, eventCount, maxThreads) != S_OK) {
+            result = E_FAIL;
+        }
+    }
+    return result;
+}
+
+HRESULT tester::executeFilterSoakTest(const GUID& guid, const SoakTester& soakTester) {
+    tester::GenericUnitTester* unitTester = getUnitTester(guid);
+    if (unitTester == nullptr) {
+        std::wcerr << L"No tester is matching GUID " << GUID_To_WString(guid) << L"!\n";
+        Logger::getInstance().error(L"No tester is matching GUID " + GUID_To_WString(guid) + L"!");
+        return E_FAIL;
     }
+
+    HRESULT result = unitTester->executeSoakTest(soakTester);
+    delete unitTester;
+    return result;
+}
+
+bool tester::preloadLibraries() {
+    bool result = true;
+
+    /// Resolving any symbol loads the scgms library for the rest of the process' lifetime
+    if (scgms::factory::resolve_symbol<scgms::TCreate_Device_Event>("create_device_event") == nullptr) {
+        Logger::getInstance().error(L"Couldn't preload scgms library!");
+        result = false;
+    }
+
+    for (const auto &guidPair : GuidFileMapper::GetInstance().getMap()) {
+        if (!FilterLibraryCache::getInstance().getFilterLibrary(guidPair.first)) {
+            result = false;
+        }
+    }
+
+    Logger::getInstance().info(result ? L"All libraries preloaded." : L"Some libraries couldn't be preloaded!");
+    return result;
 }
 
 tester::GenericUnitTester* tester::getUnitTester(const GUID& guid) {
@@ -6,17 +6,63 @@
 #include <rtl/hresult.h>
 #include <iface/DeviceIface.h>
 #include "../scgmsLibUtils.h"
+#include "../EventAuditor.h"
+
+/**
+ * Returns the event factory of scgms library. The symbol is resolved only once, on the first call.
+ *
+ * @return event factory, nullptr if the scgms library couldn't be loaded
+ */
+static scgms::TCreate_Device_Event getEventFactory() {
+    static const scgms::TCreate_Device_Event creator =
+            scgms::factory::resolve_symbol<scgms::TCreate_Device_Event>("create_device_event");
+    return creator;
+}
 
 scgms::IDevice_Event * createEvent(const scgms::NDevice_Event_Code eventCode) {
     scgms::IDevice_Event* event;
 
-    auto creator = scgms::factory::resolve_symbol<scgms::TCreate_Device_Event>("create_device_event");
+    auto creator = getEventFactory();
+    if (creator == nullptr) {
+        return nullptr;
+    }
+
     HRESULT result = creator(eventCode, &event);
     if (!Succeeded(result)) {
         return nullptr;
     }
 
-    return event;
+    return tester::EventAuditor::getInstance().track(event);
+}
+
+std::vector<scgms::IDevice_Event*> createEvents(const scgms::NDevice_Event_Code eventCode, const std::size_t count,
+                                                const GUID& signalId) {
+    std::vector<scgms::IDevice_Event*> events;
+    events.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++) {
+        scgms::IDevice_Event* event = createEvent(eventCode);
+        if (event == nullptr) {
+            releaseEvents(events);
+            return events;
+        }
+
+        if (!Is_Invalid_GUID(signalId)) {
+            scgms::TDevice_Event* raw_event;
+            event->Raw(&raw_event);
+            raw_event->signal_id = signalId;
+        }
+        events.push_back(event);
+    }
+
+    return events;
+}
+
+void releaseEvents(std::vector<scgms::IDevice_Event*>& events) {
+    for (scgms::IDevice_Event* event : events) {
+        event->Release();
+    }
+    events.clear();
 }
 
 std::wstring describeEvent(const scgms::NDevice_Event_Code eventCode) {
@@ -5,6 +5,8 @@
 #ifndef SMARTTESTER_SCGMSLIBUTILS_H
 #define SMARTTESTER_SCGMSLIBUTILS_H
 
+#include <vector>
+#include <rtl/guid.h>
 #include <iface/DeviceIface.h>
 
 /**
@@ -15,6 +17,23 @@
  * @return non-owning pointer to created event
  */
 scgms::IDevice_Event *createEvent(const scgms::NDevice_Event_Code eventCode);
+/**
+ * Creates a batch of device events with given event code and signal id, so they can be created in advance,
+ * before the measured part of a test. Returned pointers are non-owning, every event is deleted during its execution.
+ * Events which will not be executed have to be released, e.g. by releaseEvents.
+ *
+ * @param eventCode event code of created events
+ * @param count number of created events
+ * @param signalId signal id of created events, Invalid_GUID keeps the default one
+ * @return created events, empty if any of them couldn't be created
+ */
+std::vector<scgms::IDevice_Event*> createEvents(const scgms::NDevice_Event_Code eventCode, std::size_t count,
+                                                const GUID& signalId = Invalid_GUID);
+/**
+ * Releases given events which were not executed and clears the vector.
+ * @param events events to release
+ */
+void releaseEvents(std::vector<scgms::IDevice_Event*>& events);
 /**
  * Returns a string representation of given event code
  * @param event event code to describe